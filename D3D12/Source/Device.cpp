@@ -54,9 +54,28 @@ namespace RHI::D3D12
         (void)bgra;
     }
 
-    void IQueue::Submit(const QueueSubmitInfo& submitInfo)
+    uint64_t IQueue::Submit(const QueueSubmitInfo& submitInfo)
     {
         (void)submitInfo;
+        return m_fenceValue;
+    }
+
+    uint64_t IQueue::SubmitBatch(TL::Span<const QueueSubmitInfo> submitInfos)
+    {
+        uint64_t value = m_fenceValue;
+        for (const auto& submitInfo : submitInfos)
+            value = Submit(submitInfo);
+        return value;
+    }
+
+    void IQueue::Present(TL::Span<Swapchain* const> swapchains)
+    {
+        (void)swapchains;
+    }
+
+    Fence* IQueue::GetTimelineFence()
+    {
+        return nullptr;
     }
 
     void IQueue::WaitIdle()
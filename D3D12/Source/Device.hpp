@@ -21,12 +21,15 @@ namespace RHI::D3D12
         ResultCode Init(IDevice* device, const char* debugName, QueueType queueType);
         void       Shutdown();
 
-        void BeginAnnotation(const char* name, uint32_t bgra) override;
-        void EndAnnotation() override;
-        void InsertAnnotation(const char* name, uint32_t bgra) override;
-        void Submit(const QueueSubmitInfo& submitInfo) override;
-        void WaitIdle() override;
-        void WaitFence(Fence* fence, uint64_t value) override;
+        void     BeginAnnotation(const char* name, uint32_t bgra) override;
+        void     EndAnnotation() override;
+        void     InsertAnnotation(const char* name, uint32_t bgra) override;
+        uint64_t Submit(const QueueSubmitInfo& submitInfo) override;
+        uint64_t SubmitBatch(TL::Span<const QueueSubmitInfo> submitInfos) override;
+        void     Present(TL::Span<Swapchain* const> swapchains) override;
+        Fence*   GetTimelineFence() override;
+        void     WaitIdle() override;
+        void     WaitFence(Fence* fence, uint64_t value) override;
 
         IDevice*            m_device     = nullptr;
         ID3D12CommandQueue* m_queue      = nullptr;
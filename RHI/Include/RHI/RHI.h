@@ -16,11 +16,12 @@ namespace RHI
     class CommandPool;
     class CommandList;
 
-    static constexpr uint64_t RemainingSize     = UINT64_MAX;
-    static constexpr uint32_t BindlessArraySize = UINT32_MAX;
-    static constexpr uint8_t  AllLayers         = UINT8_MAX;
-    static constexpr uint8_t  AllMipLevels      = UINT8_MAX;
-    static constexpr uint32_t ShaderUnused      = UINT32_MAX;
+    static constexpr uint64_t RemainingSize        = UINT64_MAX;
+    static constexpr uint32_t BindlessArraySize    = UINT32_MAX;
+    static constexpr uint32_t InvalidBindlessIndex = UINT32_MAX;
+    static constexpr uint8_t  AllLayers            = UINT8_MAX;
+    static constexpr uint8_t  AllMipLevels         = UINT8_MAX;
+    static constexpr uint32_t ShaderUnused         = UINT32_MAX;
 
     using DeviceMemoryPtr = void*;
     using BufferAddress   = uint64_t;
@@ -206,6 +207,7 @@ namespace RHI
         StorageTexelBuffer,
         UniformBuffer,
         StorageBuffer,
+        // Dynamic bindings are unavailable when DeviceFeatures::hasDescriptorBuffer is set.
         UniformBufferDynamic,
         StorageBufferDynamic,
         InputAttachment,
@@ -409,6 +411,18 @@ namespace RHI
         Triangles,
     };
 
+    enum class GraphicsPipelineLibraryPart
+    {
+        None             = 0,
+        VertexInput      = 1 << 0, ///< Vertex bindings and topology.
+        PreRasterization = 1 << 1, ///< Vertex, hull, domain, mesh and amplification shaders, rasterizer state.
+        FragmentShader   = 1 << 2, ///< Pixel shader, depth stencil state.
+        FragmentOutput   = 1 << 3, ///< Render target formats, blend and multisample state.
+        All              = VertexInput | PreRasterization | FragmentShader | FragmentOutput,
+    };
+
+    TL_DEFINE_FLAG_OPERATORS(GraphicsPipelineLibraryPart);
+
     enum class PipelineRasterizerStateCullMode
     {
         None,
@@ -636,14 +650,17 @@ namespace RHI
     RHI_DEFINE_HANDLE(ImageView);
     RHI_DEFINE_HANDLE(Sampler);
     RHI_DEFINE_HANDLE(ShaderModule);
+    RHI_DEFINE_HANDLE(ShaderObject);
     RHI_DEFINE_HANDLE(PipelineLayout);
     RHI_DEFINE_HANDLE(GraphicsPipeline);
+    RHI_DEFINE_HANDLE(GraphicsPipelineLibrary);
     RHI_DEFINE_HANDLE(ComputePipeline);
     RHI_DEFINE_HANDLE(RayTracingPipeline);
     RHI_DEFINE_HANDLE(AccelerationStructure);
     RHI_DEFINE_HANDLE(Micromap);
     RHI_DEFINE_HANDLE(QueryPool);
     RHI_DEFINE_HANDLE(Swapchain);
+    RHI_DEFINE_HANDLE(TransientHeap);
 
     // Device
 
@@ -652,6 +669,11 @@ namespace RHI
         bool hasRaytracing;
         bool hasMeshShaders;
         bool hasPushBindGroups;
+        bool hasGraphicsPipelineLibrary;
+        bool hasDynamicColorBlendEnable;
+        bool hasShaderObject;
+        bool hasShaderModuleIdentifier;
+        bool hasDescriptorBuffer;
     };
 
     struct DeviceLimits
@@ -694,11 +716,19 @@ namespace RHI
         TL::Span<const uint32_t> code = {};
     };
 
+    struct SpecializationConstant
+    {
+        uint32_t id    = 0;
+        uint32_t size  = 4; ///< 4 for bool, int, uint and float constants, 8 for 64-bit ones.
+        uint64_t value = 0; ///< Bit pattern of the constant in the low size bytes.
+    };
+
     struct PipelineShaderStage
     {
-        const char*   name   = nullptr; ///< Entry point name.
-        ShaderModule* module = nullptr;
-        ShaderStage   stage  = ShaderStage::None;
+        const char*                            name                    = nullptr; ///< Entry point name.
+        ShaderModule*                          module                  = nullptr;
+        ShaderStage                            stage                   = ShaderStage::None;
+        TL::Span<const SpecializationConstant> specializationConstants = {};      ///< Overrides constant_id values, one module serves many variants.
     };
 
     // Bind groups & layout
@@ -726,6 +756,13 @@ namespace RHI
         uint32_t         bindlessArrayCount = 0;
     };
 
+    struct BindGroupCacheStats
+    {
+        uint64_t hitCount       = 0; ///< Requests served by an existing bind group.
+        uint64_t missCount      = 0; ///< Requests that created and wrote a new bind group.
+        uint32_t bindGroupCount = 0; ///< Cached bind groups alive, including unused ones waiting for eviction.
+    };
+
     struct BufferBindingInfo
     {
         Buffer*  buffer = nullptr;
@@ -798,6 +835,14 @@ namespace RHI
         size_t                 byteSize   = 0;
     };
 
+    // Persistently mapped sub-allocation returned by Device::AllocateDynamic.
+    struct DynamicAllocation
+    {
+        Buffer*         buffer = nullptr;
+        uint64_t        offset = 0;
+        DeviceMemoryPtr ptr    = nullptr;
+    };
+
     struct BufferSubregion
     {
         size_t offset = 0;
@@ -890,6 +935,37 @@ namespace RHI
         bool                  operator==(const ImageViewCreateInfo& other) const = default;
     };
 
+    // Transient resources
+    // Use points are indices of the passes of a frame, resources with disjoint [firstUse, lastUse] ranges may share memory.
+
+    struct TransientImageInfo
+    {
+        ImageCreateInfo createInfo = {};
+        uint32_t        firstUse   = 0;
+        uint32_t        lastUse    = 0; ///< Inclusive.
+    };
+
+    struct TransientBufferInfo
+    {
+        BufferCreateInfo createInfo = {};
+        uint32_t         firstUse   = 0;
+        uint32_t         lastUse    = 0; ///< Inclusive.
+    };
+
+    struct TransientHeapCreateInfo
+    {
+        const char*                         name    = nullptr;
+        TL::Span<const TransientImageInfo>  images  = {};
+        TL::Span<const TransientBufferInfo> buffers = {};
+    };
+
+    struct TransientHeapStats
+    {
+        uint64_t naiveSize    = 0; ///< Bytes required if every resource had its own allocation.
+        uint64_t peakSize     = 0; ///< Bytes of the shared heap.
+        uint32_t aliasedCount = 0; ///< Resources sharing memory with at least one other resource.
+    };
+
     struct SamplerCreateInfo
     {
         const char*        name       = nullptr;
@@ -1083,6 +1159,38 @@ namespace RHI
         PipelineRasterizerStateDesc               rasterizationState   = {};
         PipelineMultisampleStateDesc              multisampleState     = {};
         PipelineDepthStencilStateDesc             depthStencilState    = {};
+        // Cull mode, front face and depth stencil state, plus the blend enables when hasDynamicColorBlendEnable,
+        // are set on the command list instead of being baked, so one pipeline covers all their permutations.
+        bool                                      dynamicState         = false;
+    };
+
+    struct GraphicsPipelineLibraryCreateInfo
+    {
+        const char*                            name  = nullptr;
+        TL::Flags<GraphicsPipelineLibraryPart> parts = GraphicsPipelineLibraryPart::None;
+        GraphicsPipelineCreateInfo             state = {}; ///< Only the state belonging to parts is read.
+    };
+
+    struct GraphicsPipelineLinkInfo
+    {
+        const char*                              name      = nullptr;
+        TL::Span<GraphicsPipelineLibrary* const> libraries = {};      ///< Must cover every GraphicsPipelineLibraryPart once.
+        PipelineLayout*                          layout    = nullptr; ///< Must be the layout the libraries were created with.
+        bool                                     optimize  = false;   ///< Also builds a link time optimized pipeline in the background, used once ready.
+    };
+
+    // Shader objects carry no baked state, BindShaders records the state below and the dynamic state setters override it.
+    struct ShaderObjectCreateInfo
+    {
+        const char*                               name                 = nullptr;
+        TL::Span<const PipelineShaderStage>       shaderStages         = {}; ///< Vertex, Amplification, Mesh and Pixel stages linked together, or a single Compute stage.
+        PipelineLayout*                           layout               = nullptr;
+        TL::Span<const PipelineVertexBindingDesc> vertexBufferBindings = {};
+        PipelineColorBlendStateDesc               colorBlendState      = {};
+        PipelineTopologyMode                      topologyMode         = PipelineTopologyMode::Triangles;
+        PipelineRasterizerStateDesc               rasterizationState   = {};
+        PipelineMultisampleStateDesc              multisampleState     = {};
+        PipelineDepthStencilStateDesc             depthStencilState    = {};
     };
 
     struct ComputePipelineCreateInfo
@@ -1110,6 +1218,23 @@ namespace RHI
         uint32_t                                        maxRecursionDepth = 0;
     };
 
+    // Invoked on the compiling worker thread once an asynchronously created pipeline is done.
+    using PipelineCallback = void (*)(ResultCode result, void* userData);
+
+    struct PipelineCacheStats
+    {
+        uint64_t hitCount      = 0; ///< Create calls served by an existing pipeline.
+        uint64_t missCount     = 0; ///< Create calls that compiled a new pipeline.
+        uint32_t pipelineCount = 0; ///< Unique pipelines alive.
+    };
+
+    struct PipelineStats
+    {
+        const char* name       = nullptr; ///< Debug name of the pipeline, owned by the device.
+        uint64_t    durationNs = 0;       ///< Time the driver reported for creating the pipeline.
+        bool        cacheHit   = false;   ///< Found in the pipeline cache, nothing was compiled.
+    };
+
     // Synchronization
 
     struct FenceCreateInfo
@@ -1155,12 +1280,19 @@ namespace RHI
         BarrierState dstState = {};
     };
 
+    // Setting srcQueue and dstQueue to different queues describes a queue ownership transfer. The same barrier
+    // must be recorded on both queues: the srcQueue list performs the release and the dstQueue list the acquire.
+    // When both queues share a queue family the acquire is a no-op.
+    // Leave both as QueueType::Count when the resource stays on the recording queue.
+
     struct ImageBarrierInfo
     {
         Image*                image       = nullptr;
         ImageBarrierState     srcState    = {};
         ImageBarrierState     dstState    = {};
         ImageSubresourceRange subresource = ImageSubresourceRange::All();
+        QueueType             srcQueue    = QueueType::Count;
+        QueueType             dstQueue    = QueueType::Count;
     };
 
     struct BufferBarrierInfo
@@ -1169,6 +1301,8 @@ namespace RHI
         BufferBarrierState srcState  = {};
         BufferBarrierState dstState  = {};
         BufferSubregion    subregion = {};
+        QueueType          srcQueue  = QueueType::Count;
+        QueueType          dstQueue  = QueueType::Count;
     };
 
     // Queues
@@ -1181,6 +1315,33 @@ namespace RHI
         TL::Span<Swapchain*>            presentSwapchains = {};
     };
 
+    // Uploads
+
+    // Invoked from BeginFrame or FlushUploads once the GPU finished the copy.
+    using UploadCallback = void (*)(void* userData);
+
+    struct BufferUploadInfo
+    {
+        Buffer*        buffer   = nullptr; ///< Destination buffer, must have BufferUsage::CopyDst.
+        uint64_t       offset   = 0;       ///< Byte offset into the destination buffer.
+        const void*    data     = nullptr; ///< Source data, copied into staging memory before the call returns.
+        size_t         size     = 0;       ///< Size of data in bytes.
+        UploadCallback callback = nullptr;
+        void*          userData = nullptr;
+    };
+
+    struct ImageUploadInfo
+    {
+        Image*         image      = nullptr; ///< Destination image, must have ImageUsage::CopyDst. Left in ImageUsage::ShaderResource.
+        uint32_t       mipLevel   = 0;
+        uint32_t       arrayLayer = 0;
+        ImageAspect    aspect     = ImageAspect::All;
+        const void*    data       = nullptr; ///< Tightly packed texels of the whole mip level.
+        size_t         size       = 0;
+        UploadCallback callback   = nullptr;
+        void*          userData   = nullptr;
+    };
+
     // Passes & clears
 
     struct ColorF32
@@ -1275,6 +1436,12 @@ namespace RHI
         QueueType   queue;
     };
 
+    struct CommandPoolStats
+    {
+        uint64_t reusedCount    = 0; ///< Allocations served by a command list recycled on Reset.
+        uint64_t allocatedCount = 0; ///< Allocations that had to create a new command buffer.
+    };
+
     // Queries
 
     struct QueryPoolCreateInfo
@@ -1337,14 +1504,24 @@ namespace RHI
         Queue()          = default;
         virtual ~Queue() = default;
 
-        virtual void BeginAnnotation(const char* name, uint32_t bgra)  = 0;
-        virtual void EndAnnotation()                                   = 0;
-        virtual void InsertAnnotation(const char* name, uint32_t bgra) = 0;
+        virtual void     BeginAnnotation(const char* name, uint32_t bgra)  = 0;
+        virtual void     EndAnnotation()                                   = 0;
+        virtual void     InsertAnnotation(const char* name, uint32_t bgra) = 0;
+
+        // Returns the queue timeline value signaled when the submitted work completes.
+        // Submit presents QueueSubmitInfo::presentSwapchains right away.
+        virtual uint64_t Submit(const QueueSubmitInfo& submitInfo) = 0;
 
-        virtual void Submit(const QueueSubmitInfo& submitInfo) = 0;
+        // Issues every submit info with a single driver call. Swapchains listed in presentSwapchains
+        // are only made ready for presentation, call Present to present them.
+        virtual uint64_t SubmitBatch(TL::Span<const QueueSubmitInfo> submitInfos) = 0;
+        virtual void     Present(TL::Span<Swapchain* const> swapchains)          = 0;
 
-        virtual void WaitIdle()                              = 0;
-        virtual void WaitFence(Fence* fence, uint64_t value) = 0;
+        // Fence backing the queue timeline, can be waited on or used as a wait fence on other queues.
+        virtual Fence*   GetTimelineFence() = 0;
+
+        virtual void     WaitIdle()                              = 0;
+        virtual void     WaitFence(Fence* fence, uint64_t value) = 0;
     };
 
     class RHI_EXPORT Device
@@ -1364,10 +1541,47 @@ namespace RHI
 
         virtual Queue*                         GetQueue(QueueType queueType) = 0;
 
+        // Frames in flight
+        // BeginFrame blocks until the GPU retired the slot it returns, then recycles the slot's transient resources.
+        // EndFrame returns the graphics timeline value signaled once every submission of the frame completes.
+        virtual uint32_t                       GetFramesInFlightCount() const           = 0;
+        virtual uint32_t                       BeginFrame()                             = 0;
+        virtual uint64_t                       EndFrame()                               = 0;
+        virtual CommandPool*                   GetFrameCommandPool(QueueType queueType) = 0;
+
+        // Uploads
+        // Copies are batched on the transfer queue and become visible to the graphics queue once flushed. The returned
+        // value is signaled on GetUploadFence() when the copy completed. BeginFrame flushes pending uploads.
+        virtual uint64_t                       UploadBuffer(const BufferUploadInfo& uploadInfo) = 0;
+        virtual uint64_t                       UploadImage(const ImageUploadInfo& uploadInfo)   = 0;
+        virtual uint64_t                       FlushUploads()                                   = 0;
+        virtual Fence*                         GetUploadFence()                                 = 0;
+
+        // Pipeline cache
+        // Writes the pipeline cache to the path given at device creation, the device also saves it on shutdown.
+        virtual ResultCode                     SavePipelineCache() = 0;
+
+        // Pipeline manifest
+        // When enabled at device creation, the create info of every compiled pipeline is recorded and saved on shutdown.
+        // PrecompilePipelines creates the pipelines of a manifest, or of the recorded one when null, on threadCount threads
+        // (0 uses all hardware threads but one) and keeps them alive until the device is destroyed, so matching Create
+        // calls are cache hits. Shader modules and layouts are matched by content, so create them first; pipelines
+        // referencing ones that are not alive are skipped.
+        virtual ResultCode                     SavePipelineManifest()                                              = 0;
+        virtual ResultCode                     PrecompilePipelines(const char* manifestPath, uint32_t threadCount) = 0;
+
         // ShaderModule
+        // Modules are keyed by a hash of their code, identical code returns the same module with an added reference and
+        // each Create must be paired with a Destroy.
         virtual ShaderModule*                  CreateShaderModule(const ShaderModuleCreateInfo& createInfo) = 0;
         virtual void                           DestroyShaderModule(ShaderModule* shaderModule)              = 0;
 
+        // ShaderObject
+        // Requires DeviceFeatures::hasShaderObject. Links the stages without creating a pipeline, so creation never
+        // stalls on pipeline compilation, at the cost of recording the whole state on every BindShaders.
+        virtual ShaderObject*                  CreateShaderObject(const ShaderObjectCreateInfo& createInfo) = 0;
+        virtual void                           DestroyShaderObject(ShaderObject* handle)                    = 0;
+
         // BindGroupLayout
         virtual BindGroupLayout*               CreateBindGroupLayout(const BindGroupLayoutCreateInfo& createInfo) = 0;
         virtual void                           DestroyBindGroupLayout(BindGroupLayout* handle)                    = 0;
@@ -1376,12 +1590,36 @@ namespace RHI
         virtual BindGroup*                     CreateBindGroup(const BindGroupCreateInfo& createInfo)                    = 0;
         virtual void                           DestroyBindGroup(BindGroup* handle)                                       = 0;
         virtual void                           UpdateBindGroup(BindGroup* handle, const BindGroupUpdateInfo& updateInfo) = 0;
+        // Allocated linearly from the current frame and released with it once the GPU retired the frame, must not be
+        // passed to DestroyBindGroup. Meant for groups that are written and bound once.
+        virtual BindGroup*                     CreateTransientBindGroup(const BindGroupCreateInfo& createInfo)           = 0;
+        // Returns a bind group written with updateInfo, requests with the same layout and contents share one reference
+        // counted group. Pair each call with DestroyBindGroup and never update the result. Released groups are kept for
+        // ApplicationInfo::bindGroupCacheFrames frames before being destroyed, with the cache disabled every call
+        // creates a new group.
+        virtual BindGroup*                     CreateCachedBindGroup(const BindGroupCreateInfo& createInfo, const BindGroupUpdateInfo& updateInfo) = 0;
+        virtual BindGroupCacheStats            GetBindGroupCacheStats()                                                                            = 0;
+
+        // Bindless heap
+        // Device owned bind group with arrays of sampled images (binding 0), storage buffers (binding 1) and samplers
+        // (binding 2). Register* returns a stable index into the matching array, or InvalidBindlessIndex when it is full.
+        // Unregistered indices are recycled once the GPU retired the frame they were unregistered in. Pipeline layouts
+        // containing GetBindlessBindGroupLayout() have the heap bound by the command list, place it after the groups
+        // passed to SetBindGroups. Register* and Unregister* may be called from any thread, e.g. while streaming assets.
+        virtual BindGroupLayout*               GetBindlessBindGroupLayout()      = 0;
+        virtual uint32_t                       RegisterImage(Image* image)       = 0;
+        virtual uint32_t                       RegisterBuffer(Buffer* buffer)    = 0;
+        virtual uint32_t                       RegisterSampler(Sampler* sampler) = 0;
+        virtual void                           UnregisterImage(uint32_t index)   = 0;
+        virtual void                           UnregisterBuffer(uint32_t index)  = 0;
+        virtual void                           UnregisterSampler(uint32_t index) = 0;
 
         // PipelineLayout
         virtual PipelineLayout*                CreatePipelineLayout(const PipelineLayoutCreateInfo& createInfo) = 0;
         virtual void                           DestroyPipelineLayout(PipelineLayout* handle)                    = 0;
 
         // Pipelines
+        // Identical create infos return the same pipeline with an added reference, each Create must be paired with a Destroy.
         virtual GraphicsPipeline*              CreateGraphicsPipeline(const GraphicsPipelineCreateInfo& createInfo)                                 = 0;
         virtual void                           DestroyGraphicsPipeline(GraphicsPipeline* handle)                                                    = 0;
         virtual ComputePipeline*               CreateComputePipeline(const ComputePipelineCreateInfo& createInfo)                                   = 0;
@@ -1390,6 +1628,29 @@ namespace RHI
         virtual void                           DestroyRayTracingPipeline(RayTracingPipeline* handle)                                                = 0;
         virtual void                           GetShaderBindingTableEntry(RayTracingPipeline* handle, uint32_t group, size_t size, void* dstHandle) = 0;
 
+        // Async pipelines
+        // Return immediately and compile on a worker pool sharing the pipeline cache. The create info is copied, but shader
+        // modules and the layout must stay alive until the callback runs. Bind a pipeline only once IsPipelineReady returns
+        // true; destroying a pipeline still being compiled blocks until its compilation finished.
+        virtual GraphicsPipeline*              CreateGraphicsPipelineAsync(const GraphicsPipelineCreateInfo& createInfo, PipelineCallback callback = nullptr, void* userData = nullptr)     = 0;
+        virtual ComputePipeline*               CreateComputePipelineAsync(const ComputePipelineCreateInfo& createInfo, PipelineCallback callback = nullptr, void* userData = nullptr)       = 0;
+        virtual RayTracingPipeline*            CreateRayTracingPipelineAsync(const RayTracingPipelineCreateInfo& createInfo, PipelineCallback callback = nullptr, void* userData = nullptr) = 0;
+        virtual bool                           IsPipelineReady(const GraphicsPipeline* handle)   = 0;
+        virtual bool                           IsPipelineReady(const ComputePipeline* handle)    = 0;
+        virtual bool                           IsPipelineReady(const RayTracingPipeline* handle) = 0;
+        virtual PipelineCacheStats             GetPipelineCacheStats()                           = 0;
+        // Copies the stats of the slowest pipelines created so far into stats, slowest first, and returns how many
+        // pipelines were created. Every driver pipeline creation is recorded, including deduplicated and destroyed ones.
+        virtual uint32_t                       GetPipelineStats(TL::Span<PipelineStats> stats)   = 0;
+
+        // Pipeline libraries
+        // Requires DeviceFeatures::hasGraphicsPipelineLibrary. Parts are compiled once and linked into full pipelines,
+        // which is far cheaper than a monolithic compile. Linked pipelines are deduplicated like CreateGraphicsPipeline
+        // and destroyed with DestroyGraphicsPipeline.
+        virtual GraphicsPipelineLibrary*       CreateGraphicsPipelineLibrary(const GraphicsPipelineLibraryCreateInfo& createInfo) = 0;
+        virtual void                           DestroyGraphicsPipelineLibrary(GraphicsPipelineLibrary* handle)                    = 0;
+        virtual GraphicsPipeline*              LinkGraphicsPipeline(const GraphicsPipelineLinkInfo& linkInfo)                     = 0;
+
         // Buffer
         virtual Buffer*                        CreateBuffer(const BufferCreateInfo& createInfo)               = 0;
         virtual void                           DestroyBuffer(Buffer* handle)                                  = 0;
@@ -1397,11 +1658,24 @@ namespace RHI
         virtual DeviceMemoryPtr                MapBuffer(Buffer* buffer, uint64_t offset, uint64_t sizeBytes) = 0;
         virtual void                           UnmapBuffer(Buffer* buffer)                                    = 0;
 
+        // Dynamic data
+        // Bump allocates from a persistently mapped ring, valid until the GPU retired the frame it was allocated in.
+        // An alignment of 0 honours both minUniformBufferOffsetAlignment and minStorageBufferOffsetAlignment.
+        virtual DynamicAllocation              AllocateDynamic(size_t size, size_t alignment = 0) = 0;
+
         // Image
         virtual Image*                         CreateImage(const ImageCreateInfo& createInfo)         = 0;
         virtual Image*                         CreateImageView(const ImageViewCreateInfo& createInfo) = 0;
         virtual void                           DestroyImage(Image* handle)                            = 0;
 
+        // TransientHeap
+        // Images returned by GetTransientImage hold undefined content on first use, their first barrier must use ImageUsage::None.
+        virtual TransientHeap*                 CreateTransientHeap(const TransientHeapCreateInfo& createInfo) = 0;
+        virtual void                           DestroyTransientHeap(TransientHeap* handle)                    = 0;
+        virtual Image*                         GetTransientImage(TransientHeap* handle, uint32_t index)       = 0;
+        virtual Buffer*                        GetTransientBuffer(TransientHeap* handle, uint32_t index)      = 0;
+        virtual TransientHeapStats             GetTransientHeapStats(TransientHeap* handle)                   = 0;
+
         // Sampler
         virtual Sampler*                       CreateSampler(const SamplerCreateInfo& createInfo) = 0;
         virtual void                           DestroySampler(Sampler* handle)                    = 0;
@@ -1445,8 +1719,9 @@ namespace RHI
     class RHI_EXPORT CommandPool
     {
     public:
-        virtual void         Reset()    = 0;
-        virtual CommandList* Allocate() = 0;
+        virtual void             Reset()          = 0;
+        virtual CommandList*     Allocate()       = 0;
+        virtual CommandPoolStats GetStats() const = 0;
     };
 
     class RHI_EXPORT CommandList
@@ -1466,6 +1741,8 @@ namespace RHI
 
         // Synchronization
         virtual void AddPipelineBarrier(TL::Span<const BarrierInfo> barriers, TL::Span<const ImageBarrierInfo> imageBarriers, TL::Span<const BufferBarrierInfo> bufferBarriers) = 0;
+        // Orders transient resources first used at usePoint after the last use of the resources they alias. Record before the pass.
+        virtual void AddAliasingBarriers(TransientHeap* heap, uint32_t usePoint) = 0;
 
         // Pass setup
         virtual void BeginRenderPass(const RenderPassBeginInfo& beginInfo)   = 0;
@@ -1486,10 +1763,17 @@ namespace RHI
         virtual void BindGraphicsPipeline(const GraphicsPipeline* pipelineState)                                              = 0;
         virtual void BindComputePipeline(const ComputePipeline* pipelineState)                                                = 0;
         virtual void BindRayTracingPipeline(const RayTracingPipeline* pipelineState)                                          = 0;
+        virtual void BindShaders(const ShaderObject* shaderObject)                                                            = 0;
 
         // Dynamic state
         virtual void SetViewport(float offsetX, float offsetY, float width, float height, float minDepth, float maxDepth) = 0;
         virtual void SetScissor(int32_t offsetX, int32_t offsetY, uint32_t width, uint32_t height)                        = 0;
+        // Only affect shader objects and pipelines created with dynamicState, values left unchanged since the last call are skipped.
+        virtual void SetCullMode(PipelineRasterizerStateCullMode cullMode)                                                = 0;
+        virtual void SetFrontFace(PipelineRasterizerStateFrontFace frontFace)                                             = 0;
+        virtual void SetDepthState(const PipelineDepthStencilStateDesc& depthStencilState)                                = 0;
+        // Requires DeviceFeatures::hasDynamicColorBlendEnable, unless shaders were bound with BindShaders.
+        virtual void SetColorBlendEnable(uint32_t firstAttachment, TL::Span<const bool> enables)                          = 0;
 
         // Vertex input
         virtual void BindVertexBuffers(uint32_t firstBinding, TL::Span<const BufferBindingInfo> vertexBuffers) = 0;
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <RHI/RHI.h>
+
+#include <TL/Containers/Vector.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace RHI
+{
+    class RenderGraph;
+
+    struct RGImage
+    {
+        uint32_t index = UINT32_MAX;
+
+        bool     IsValid() const { return index != UINT32_MAX; }
+    };
+
+    struct RGBuffer
+    {
+        uint32_t index = UINT32_MAX;
+
+        bool     IsValid() const { return index != UINT32_MAX; }
+    };
+
+    // Invoked while recording the pass, inside the render pass when the pass declared attachments.
+    using RGExecuteCallback = std::function<void(CommandList& commandList)>;
+
+    struct RenderGraphCreateInfo
+    {
+        const char* name        = nullptr;
+        uint32_t    workerCount = 1; ///< Threads recording passes in parallel, 1 records on the calling thread.
+    };
+
+    struct RenderGraphStats
+    {
+        uint32_t           passCount       = 0;
+        uint32_t           culledPassCount = 0;
+        uint32_t           barrierCount    = 0;
+        uint64_t           compileTimeUs   = 0; ///< Duration of the last Compile call.
+        TransientHeapStats memory          = {};
+    };
+
+    // Declares the resources a pass reads and writes, returned by RenderGraph::AddPass.
+    class RHI_EXPORT RGPassBuilder
+    {
+    public:
+        // Transient resources live in memory shared with other transient resources that are not alive at the same time.
+        RGImage  CreateImage(const ImageCreateInfo& createInfo);
+        RGBuffer CreateBuffer(const BufferCreateInfo& createInfo);
+
+        void     ReadImage(RGImage image, TL::Flags<PipelineStage> stage, ImageUsage usage = ImageUsage::ShaderResource);
+        void     WriteImage(RGImage image, TL::Flags<PipelineStage> stage, ImageUsage usage = ImageUsage::StorageResource);
+        void     ReadBuffer(RGBuffer buffer, TL::Flags<PipelineStage> stage, BufferUsage usage = BufferUsage::Storage);
+        void     WriteBuffer(RGBuffer buffer, TL::Flags<PipelineStage> stage, BufferUsage usage = BufferUsage::Storage);
+
+        void     AddColorAttachment(RGImage image, LoadOperation loadOp = LoadOperation::Discard, StoreOperation storeOp = StoreOperation::Store, ClearValue clearValue = {});
+        void     SetDepthStencilAttachment(RGImage image, LoadOperation loadOp = LoadOperation::Discard, StoreOperation storeOp = StoreOperation::Store, DepthStencilValue clearValue = {});
+
+        // Keeps the pass even if none of its outputs are consumed.
+        void     SetSideEffect();
+
+    private:
+        friend class RenderGraph;
+
+        RGPassBuilder(RenderGraph* graph, uint32_t passIndex)
+            : m_graph(graph)
+            , m_passIndex(passIndex)
+        {
+        }
+
+        RenderGraph* m_graph;
+        uint32_t     m_passIndex;
+    };
+
+    // Backend agnostic frame graph: passes declare their accesses, the graph culls unused passes, derives the
+    // barriers between them, aliases transient resources and records the passes onto command lists.
+    // Resource state is tracked per resource, not per subresource.
+    class RHI_EXPORT RenderGraph
+    {
+    public:
+        RenderGraph(Device* device, const RenderGraphCreateInfo& createInfo);
+        ~RenderGraph();
+
+        // Removes every pass and resource. The transient heap is kept and reused if the next Compile needs the same one.
+        void                         Reset();
+
+        // Imported resources are never aliased and are transitioned to finalState after the last pass.
+        RGImage                      ImportImage(Image* image, ImageSize2D size, ImageBarrierState initialState, ImageBarrierState finalState);
+        RGBuffer                     ImportBuffer(Buffer* buffer, BufferBarrierState initialState, BufferBarrierState finalState);
+
+        RGPassBuilder                AddPass(const char* name, RGExecuteCallback execute);
+
+        void                         Compile();
+
+        // Records every pass kept by Compile, frameIndex is the slot returned by Device::BeginFrame.
+        // The returned command lists must be submitted in order to the graphics queue.
+        TL::Span<CommandList* const> Record(uint32_t frameIndex);
+
+        Image*                       GetImage(RGImage image) const;
+        Buffer*                      GetBuffer(RGBuffer buffer) const;
+
+        const RenderGraphStats&      GetStats() const { return m_stats; }
+
+    private:
+        friend class RGPassBuilder;
+
+        struct ImageResource
+        {
+            ImageCreateInfo   createInfo     = {};
+            Image*            image          = nullptr;
+            ImageSize2D       size           = {};
+            bool              imported       = false;
+            ImageBarrierState initialState   = {};
+            ImageBarrierState finalState     = {};
+            uint32_t          transientIndex = UINT32_MAX;
+        };
+
+        struct BufferResource
+        {
+            BufferCreateInfo   createInfo     = {};
+            Buffer*            buffer         = nullptr;
+            bool               imported       = false;
+            BufferBarrierState initialState   = {};
+            BufferBarrierState finalState     = {};
+            uint32_t           transientIndex = UINT32_MAX;
+        };
+
+        struct ImageAccess
+        {
+            uint32_t          image;
+            ImageBarrierState state;
+        };
+
+        struct BufferAccess
+        {
+            uint32_t           buffer;
+            BufferBarrierState state;
+        };
+
+        struct Attachment
+        {
+            uint32_t       image;
+            LoadOperation  loadOp;
+            StoreOperation storeOp;
+            ClearValue     clearValue;
+        };
+
+        struct Pass
+        {
+            const char*              name;
+            RGExecuteCallback        execute;
+            TL::Vector<ImageAccess>  imageAccesses;
+            TL::Vector<BufferAccess> bufferAccesses;
+            TL::Vector<Attachment>   colorAttachments;
+            Attachment               depthStencilAttachment = {UINT32_MAX};
+            bool                     sideEffect             = false;
+        };
+
+        // A pass kept by Compile, with the barriers recorded before it.
+        struct CompiledPass
+        {
+            uint32_t                      pass;
+            TL::Vector<ImageBarrierInfo>  imageBarriers;
+            TL::Vector<BufferBarrierInfo> bufferBarriers;
+        };
+
+        void AddImageAccess(uint32_t pass, uint32_t image, ImageBarrierState state);
+        void AddBufferAccess(uint32_t pass, uint32_t buffer, BufferBarrierState state);
+        void CullPasses(TL::Vector<bool>& alive);
+        void PlaceTransientResources();
+        void ComputeBarriers();
+        void RecordPass(CommandList& commandList, const CompiledPass& compiledPass);
+        void RecordWorker(uint32_t worker);
+        void WorkerMain(uint32_t worker);
+
+        Device*                         m_device;
+        TL::String                      m_name;
+        uint32_t                        m_workerCount;
+
+        TL::Vector<Pass>                m_passes;
+        TL::Vector<ImageResource>       m_images;
+        TL::Vector<BufferResource>      m_buffers;
+
+        TL::Vector<CompiledPass>        m_compiledPasses;
+        TL::Vector<ImageBarrierInfo>    m_finalImageBarriers;
+        TL::Vector<BufferBarrierInfo>   m_finalBufferBarriers;
+
+        // Descriptions m_transientHeap was created from, compared on Compile to reuse the heap.
+        TransientHeap*                  m_transientHeap = nullptr;
+        TL::Vector<TransientImageInfo>  m_transientImages;
+        TL::Vector<TransientBufferInfo> m_transientBuffers;
+
+        // m_workerCount pools per frame in flight.
+        TL::Vector<CommandPool*>        m_commandPools;
+        TL::Vector<CommandList*>        m_commandLists;
+
+        // Workers 1 to m_workerCount - 1 live as long as the graph, the calling thread records as worker 0.
+        // Record bumps m_recordGeneration to start them and waits until m_pendingWorkers dropped to zero.
+        TL::Vector<std::thread>         m_workers;
+        std::mutex                      m_workerMutex;
+        std::condition_variable         m_workerCondition;
+        std::condition_variable         m_idleCondition;
+        uint64_t                        m_recordGeneration = 0;
+        uint32_t                        m_pendingWorkers   = 0;
+        bool                            m_stopWorkers      = false;
+        // Workers and passes of the Record in progress.
+        uint32_t                        m_recordWorkerCount = 0;
+        uint32_t                        m_passesPerWorker   = 0;
+
+        RenderGraphStats                m_stats;
+    };
+} // namespace RHI
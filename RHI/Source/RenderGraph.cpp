@@ -0,0 +1,585 @@
+#include "RHI/RenderGraph.hpp"
+
+#include <TL/Assert.hpp>
+#include <TL/Fmt.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <tracy/Tracy.hpp>
+
+namespace RHI
+{
+    inline static bool IsSameImage(const TransientImageInfo& a, const TransientImageInfo& b)
+    {
+        return a.createInfo.usageFlags == b.createInfo.usageFlags &&
+               a.createInfo.type == b.createInfo.type &&
+               a.createInfo.size == b.createInfo.size &&
+               a.createInfo.format == b.createInfo.format &&
+               a.createInfo.sampleCount == b.createInfo.sampleCount &&
+               a.createInfo.mipLevels == b.createInfo.mipLevels &&
+               a.createInfo.arrayCount == b.createInfo.arrayCount &&
+               a.firstUse == b.firstUse &&
+               a.lastUse == b.lastUse;
+    }
+
+    inline static bool IsSameBuffer(const TransientBufferInfo& a, const TransientBufferInfo& b)
+    {
+        return a.createInfo.usageFlags == b.createInfo.usageFlags &&
+               a.createInfo.byteSize == b.createInfo.byteSize &&
+               a.firstUse == b.firstUse &&
+               a.lastUse == b.lastUse;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    /// RGPassBuilder
+    //////////////////////////////////////////////////////////////////////////////////////////
+
+    RGImage RGPassBuilder::CreateImage(const ImageCreateInfo& createInfo)
+    {
+        m_graph->m_images.push_back({
+            .createInfo = createInfo,
+            .size       = {createInfo.size.width, createInfo.size.height},
+        });
+        return {uint32_t(m_graph->m_images.size() - 1)};
+    }
+
+    RGBuffer RGPassBuilder::CreateBuffer(const BufferCreateInfo& createInfo)
+    {
+        m_graph->m_buffers.push_back({.createInfo = createInfo});
+        return {uint32_t(m_graph->m_buffers.size() - 1)};
+    }
+
+    void RGPassBuilder::ReadImage(RGImage image, TL::Flags<PipelineStage> stage, ImageUsage usage)
+    {
+        m_graph->AddImageAccess(m_passIndex, image.index, {usage, stage, Access::Read});
+    }
+
+    void RGPassBuilder::WriteImage(RGImage image, TL::Flags<PipelineStage> stage, ImageUsage usage)
+    {
+        m_graph->AddImageAccess(m_passIndex, image.index, {usage, stage, Access::Write});
+    }
+
+    void RGPassBuilder::ReadBuffer(RGBuffer buffer, TL::Flags<PipelineStage> stage, BufferUsage usage)
+    {
+        m_graph->AddBufferAccess(m_passIndex, buffer.index, {usage, stage, Access::Read});
+    }
+
+    void RGPassBuilder::WriteBuffer(RGBuffer buffer, TL::Flags<PipelineStage> stage, BufferUsage usage)
+    {
+        m_graph->AddBufferAccess(m_passIndex, buffer.index, {usage, stage, Access::Write});
+    }
+
+    void RGPassBuilder::AddColorAttachment(RGImage image, LoadOperation loadOp, StoreOperation storeOp, ClearValue clearValue)
+    {
+        TL::Flags<Access> access = loadOp == LoadOperation::Load ? Access::ReadWrite : Access::Write;
+        m_graph->AddImageAccess(m_passIndex, image.index, {ImageUsage::Color, PipelineStage::ColorAttachmentOutput, access});
+        m_graph->m_passes[m_passIndex].colorAttachments.push_back({image.index, loadOp, storeOp, clearValue});
+    }
+
+    void RGPassBuilder::SetDepthStencilAttachment(RGImage image, LoadOperation loadOp, StoreOperation storeOp, DepthStencilValue clearValue)
+    {
+        TL::Flags<Access> access = loadOp == LoadOperation::Load ? Access::ReadWrite : Access::Write;
+        m_graph->AddImageAccess(m_passIndex, image.index, {ImageUsage::DepthStencil, PipelineStage::EarlyFragmentTests | PipelineStage::LateFragmentTests, access});
+
+        ClearValue value;
+        value.ds = clearValue;
+        m_graph->m_passes[m_passIndex].depthStencilAttachment = {image.index, loadOp, storeOp, value};
+    }
+
+    void RGPassBuilder::SetSideEffect()
+    {
+        m_graph->m_passes[m_passIndex].sideEffect = true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    /// RenderGraph
+    //////////////////////////////////////////////////////////////////////////////////////////
+
+    RenderGraph::RenderGraph(Device* device, const RenderGraphCreateInfo& createInfo)
+        : m_device(device)
+        , m_name(createInfo.name ? createInfo.name : "RenderGraph")
+        , m_workerCount(std::max(createInfo.workerCount, 1u))
+    {
+        for (uint32_t worker = 1; worker < m_workerCount; ++worker)
+            m_workers.emplace_back(&RenderGraph::WorkerMain, this, worker);
+    }
+
+    RenderGraph::~RenderGraph()
+    {
+        {
+            std::lock_guard lock(m_workerMutex);
+            m_stopWorkers = true;
+        }
+        m_workerCondition.notify_all();
+        for (auto& worker : m_workers)
+            worker.join();
+
+        for (auto commandPool : m_commandPools)
+            m_device->DestroyCommandPool(commandPool);
+
+        if (m_transientHeap)
+            m_device->DestroyTransientHeap(m_transientHeap);
+    }
+
+    void RenderGraph::Reset()
+    {
+        m_passes.clear();
+        m_images.clear();
+        m_buffers.clear();
+        m_compiledPasses.clear();
+        m_finalImageBarriers.clear();
+        m_finalBufferBarriers.clear();
+    }
+
+    RGImage RenderGraph::ImportImage(Image* image, ImageSize2D size, ImageBarrierState initialState, ImageBarrierState finalState)
+    {
+        m_images.push_back({
+            .image        = image,
+            .size         = size,
+            .imported     = true,
+            .initialState = initialState,
+            .finalState   = finalState,
+        });
+        return {uint32_t(m_images.size() - 1)};
+    }
+
+    RGBuffer RenderGraph::ImportBuffer(Buffer* buffer, BufferBarrierState initialState, BufferBarrierState finalState)
+    {
+        m_buffers.push_back({
+            .buffer       = buffer,
+            .imported     = true,
+            .initialState = initialState,
+            .finalState   = finalState,
+        });
+        return {uint32_t(m_buffers.size() - 1)};
+    }
+
+    RGPassBuilder RenderGraph::AddPass(const char* name, RGExecuteCallback execute)
+    {
+        m_passes.push_back({.name = name, .execute = std::move(execute)});
+        return RGPassBuilder(this, uint32_t(m_passes.size() - 1));
+    }
+
+    void RenderGraph::AddImageAccess(uint32_t passIndex, uint32_t image, ImageBarrierState state)
+    {
+        TL_ASSERT(image < m_images.size());
+
+        // Several accesses of one resource in a pass collapse into one, the resource can only be in one layout.
+        for (auto& access : m_passes[passIndex].imageAccesses)
+        {
+            if (access.image != image)
+                continue;
+            TL_ASSERT(access.state.usage == state.usage, "Image is used with two different usages in the same pass");
+            access.state.stage  |= state.stage;
+            access.state.access |= state.access;
+            return;
+        }
+        m_passes[passIndex].imageAccesses.push_back({image, state});
+    }
+
+    void RenderGraph::AddBufferAccess(uint32_t passIndex, uint32_t buffer, BufferBarrierState state)
+    {
+        TL_ASSERT(buffer < m_buffers.size());
+
+        for (auto& access : m_passes[passIndex].bufferAccesses)
+        {
+            if (access.buffer != buffer)
+                continue;
+            access.state.stage  |= state.stage;
+            access.state.access |= state.access;
+            return;
+        }
+        m_passes[passIndex].bufferAccesses.push_back({buffer, state});
+    }
+
+    void RenderGraph::Compile()
+    {
+        ZoneScoped;
+
+        auto start = std::chrono::steady_clock::now();
+
+        TL::Vector<bool> alive(m_passes.size(), false);
+        CullPasses(alive);
+
+        m_compiledPasses.clear();
+        for (uint32_t i = 0; i < m_passes.size(); ++i)
+        {
+            if (alive[i])
+                m_compiledPasses.push_back({.pass = i});
+        }
+
+        PlaceTransientResources();
+        ComputeBarriers();
+
+        m_stats.passCount       = uint32_t(m_compiledPasses.size());
+        m_stats.culledPassCount = uint32_t(m_passes.size() - m_compiledPasses.size());
+        m_stats.compileTimeUs   = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void RenderGraph::CullPasses(TL::Vector<bool>& alive)
+    {
+        ZoneScoped;
+
+        // Walk backwards from the passes with visible results: side effects or writes to imported resources.
+        TL::Vector<bool> imageNeeded(m_images.size(), false);
+        TL::Vector<bool> bufferNeeded(m_buffers.size(), false);
+
+        for (uint32_t i = uint32_t(m_passes.size()); i-- > 0;)
+        {
+            const Pass& pass   = m_passes[i];
+            bool        isUsed = pass.sideEffect;
+            for (const auto& access : pass.imageAccesses)
+            {
+                if ((access.state.access & Access::Write) && (m_images[access.image].imported || imageNeeded[access.image]))
+                    isUsed = true;
+            }
+            for (const auto& access : pass.bufferAccesses)
+            {
+                if ((access.state.access & Access::Write) && (m_buffers[access.buffer].imported || bufferNeeded[access.buffer]))
+                    isUsed = true;
+            }
+
+            if (!isUsed)
+                continue;
+
+            alive[i] = true;
+            for (const auto& access : pass.imageAccesses)
+            {
+                if (access.state.access & Access::Read)
+                    imageNeeded[access.image] = true;
+            }
+            for (const auto& access : pass.bufferAccesses)
+            {
+                if (access.state.access & Access::Read)
+                    bufferNeeded[access.buffer] = true;
+            }
+        }
+    }
+
+    void RenderGraph::PlaceTransientResources()
+    {
+        ZoneScoped;
+
+        // Use points are indices into m_compiledPasses, usage flags are the union of every declared access.
+        TL::Vector<TransientImageInfo>  transientImages;
+        TL::Vector<TransientBufferInfo> transientBuffers;
+        for (auto& image : m_images)
+            image.transientIndex = UINT32_MAX;
+        for (auto& buffer : m_buffers)
+            buffer.transientIndex = UINT32_MAX;
+
+        for (uint32_t usePoint = 0; usePoint < m_compiledPasses.size(); ++usePoint)
+        {
+            const Pass& pass = m_passes[m_compiledPasses[usePoint].pass];
+            for (const auto& access : pass.imageAccesses)
+            {
+                ImageResource& image = m_images[access.image];
+                if (image.imported)
+                    continue;
+
+                if (image.transientIndex == UINT32_MAX)
+                {
+                    image.transientIndex = uint32_t(transientImages.size());
+                    transientImages.push_back({.createInfo = image.createInfo, .firstUse = usePoint});
+                }
+                auto& transient                  = transientImages[image.transientIndex];
+                transient.createInfo.usageFlags |= access.state.usage;
+                transient.lastUse                = usePoint;
+            }
+            for (const auto& access : pass.bufferAccesses)
+            {
+                BufferResource& buffer = m_buffers[access.buffer];
+                if (buffer.imported)
+                    continue;
+
+                if (buffer.transientIndex == UINT32_MAX)
+                {
+                    buffer.transientIndex = uint32_t(transientBuffers.size());
+                    transientBuffers.push_back({.createInfo = buffer.createInfo, .firstUse = usePoint});
+                }
+                auto& transient                  = transientBuffers[buffer.transientIndex];
+                transient.createInfo.usageFlags |= access.state.usage;
+                transient.lastUse                = usePoint;
+            }
+        }
+
+        bool sameHeap = m_transientHeap != nullptr &&
+                        std::equal(transientImages.begin(), transientImages.end(), m_transientImages.begin(), m_transientImages.end(), IsSameImage) &&
+                        std::equal(transientBuffers.begin(), transientBuffers.end(), m_transientBuffers.begin(), m_transientBuffers.end(), IsSameBuffer);
+        if (!sameHeap)
+        {
+            // Released through the device's deferred deletion, frames in flight keep using the old memory.
+            if (m_transientHeap)
+                m_device->DestroyTransientHeap(m_transientHeap);
+            m_transientHeap = nullptr;
+            m_stats.memory  = {};
+
+            if (!transientImages.empty() || !transientBuffers.empty())
+            {
+                auto name       = TL::fmt("{} - transient heap", m_name);
+                m_transientHeap = m_device->CreateTransientHeap({.name = name.c_str(), .images = transientImages, .buffers = transientBuffers});
+                m_stats.memory  = m_device->GetTransientHeapStats(m_transientHeap);
+            }
+            m_transientImages  = std::move(transientImages);
+            m_transientBuffers = std::move(transientBuffers);
+        }
+
+        for (auto& image : m_images)
+        {
+            if (!image.imported)
+                image.image = image.transientIndex != UINT32_MAX ? m_device->GetTransientImage(m_transientHeap, image.transientIndex) : nullptr;
+        }
+        for (auto& buffer : m_buffers)
+        {
+            if (!buffer.imported)
+                buffer.buffer = buffer.transientIndex != UINT32_MAX ? m_device->GetTransientBuffer(m_transientHeap, buffer.transientIndex) : nullptr;
+        }
+    }
+
+    void RenderGraph::ComputeBarriers()
+    {
+        ZoneScoped;
+
+        TL::Vector<ImageBarrierState>  imageStates(m_images.size());
+        TL::Vector<BufferBarrierState> bufferStates(m_buffers.size());
+        for (uint32_t i = 0; i < m_images.size(); ++i)
+            imageStates[i] = m_images[i].initialState;
+        for (uint32_t i = 0; i < m_buffers.size(); ++i)
+            bufferStates[i] = m_buffers[i].initialState;
+
+        m_stats.barrierCount = 0;
+
+        for (auto& compiledPass : m_compiledPasses)
+        {
+            const Pass& pass = m_passes[compiledPass.pass];
+
+            for (const auto& access : pass.imageAccesses)
+            {
+                ImageBarrierState& current = imageStates[access.image];
+
+                // Reads in the same layout only need a barrier when they add stages the previous one did not cover.
+                bool hazard = (current.access & Access::Write) || (access.state.access & Access::Write) || current.usage != access.state.usage;
+                if (!hazard && (current.stage | access.state.stage) == current.stage)
+                    continue;
+
+                compiledPass.imageBarriers.push_back({
+                    .image    = m_images[access.image].image,
+                    .srcState = current,
+                    .dstState = access.state,
+                });
+
+                if (hazard)
+                    current = access.state;
+                else
+                    current.stage |= access.state.stage;
+            }
+
+            for (const auto& access : pass.bufferAccesses)
+            {
+                BufferBarrierState& current = bufferStates[access.buffer];
+
+                // Nothing to wait on before the first access of a transient buffer. Imported buffers may still be
+                // in use by work submitted before the graph, even without a declared initial state.
+                if (!m_buffers[access.buffer].imported && current.stage == PipelineStage::None && current.access == Access::None)
+                {
+                    current = access.state;
+                    continue;
+                }
+
+                bool hazard = (current.access & Access::Write) || (access.state.access & Access::Write);
+                if (!hazard && (current.stage | access.state.stage) == current.stage)
+                    continue;
+
+                compiledPass.bufferBarriers.push_back({
+                    .buffer   = m_buffers[access.buffer].buffer,
+                    .srcState = current,
+                    .dstState = access.state,
+                });
+
+                if (hazard)
+                    current = access.state;
+                else
+                    current.stage |= access.state.stage;
+            }
+
+            m_stats.barrierCount += uint32_t(compiledPass.imageBarriers.size() + compiledPass.bufferBarriers.size());
+        }
+
+        m_finalImageBarriers.clear();
+        m_finalBufferBarriers.clear();
+        for (uint32_t i = 0; i < m_images.size(); ++i)
+        {
+            const ImageResource& image = m_images[i];
+            if (image.imported && image.finalState.usage != ImageUsage::None && imageStates[i] != image.finalState)
+                m_finalImageBarriers.push_back({.image = image.image, .srcState = imageStates[i], .dstState = image.finalState});
+        }
+        for (uint32_t i = 0; i < m_buffers.size(); ++i)
+        {
+            const BufferResource& buffer = m_buffers[i];
+            if (buffer.imported && buffer.finalState.stage != PipelineStage::None && bufferStates[i] != buffer.finalState)
+                m_finalBufferBarriers.push_back({.buffer = buffer.buffer, .srcState = bufferStates[i], .dstState = buffer.finalState});
+        }
+        m_stats.barrierCount += uint32_t(m_finalImageBarriers.size() + m_finalBufferBarriers.size());
+    }
+
+    TL::Span<CommandList* const> RenderGraph::Record(uint32_t frameIndex)
+    {
+        ZoneScoped;
+
+        if (m_commandPools.empty())
+        {
+            uint32_t framesInFlight = m_device->GetFramesInFlightCount();
+            for (uint32_t frame = 0; frame < framesInFlight; ++frame)
+            {
+                for (uint32_t worker = 0; worker < m_workerCount; ++worker)
+                {
+                    auto name = TL::fmt("{} - frame[{}] worker[{}]", m_name, frame, worker);
+                    m_commandPools.push_back(m_device->CreateCommandPool({.name = name.c_str(), .queue = QueueType::Graphics}));
+                }
+            }
+        }
+
+        // Every worker records a contiguous range of passes into its own pool, barriers were resolved by Compile.
+        uint32_t passCount  = uint32_t(m_compiledPasses.size());
+        m_recordWorkerCount = std::clamp(passCount, 1u, m_workerCount);
+        m_passesPerWorker   = (passCount + m_recordWorkerCount - 1) / m_recordWorkerCount;
+
+        m_commandLists.clear();
+        for (uint32_t worker = 0; worker < m_recordWorkerCount; ++worker)
+        {
+            CommandPool* commandPool = m_commandPools[frameIndex * m_workerCount + worker];
+            commandPool->Reset();
+            m_commandLists.push_back(commandPool->Allocate());
+        }
+
+        if (m_recordWorkerCount > 1)
+        {
+            {
+                std::lock_guard lock(m_workerMutex);
+                m_pendingWorkers = m_recordWorkerCount - 1;
+                m_recordGeneration++;
+            }
+            m_workerCondition.notify_all();
+        }
+
+        RecordWorker(0);
+
+        std::unique_lock lock(m_workerMutex);
+        m_idleCondition.wait(lock, [this]() { return m_pendingWorkers == 0; });
+        return m_commandLists;
+    }
+
+    void RenderGraph::RecordWorker(uint32_t worker)
+    {
+        uint32_t     passCount   = uint32_t(m_compiledPasses.size());
+        CommandList& commandList = *m_commandLists[worker];
+        commandList.Begin();
+
+        uint32_t begin = std::min(worker * m_passesPerWorker, passCount);
+        uint32_t end   = std::min(begin + m_passesPerWorker, passCount);
+        for (uint32_t i = begin; i < end; ++i)
+            RecordPass(commandList, m_compiledPasses[i]);
+
+        if (worker == m_recordWorkerCount - 1)
+            commandList.AddPipelineBarrier({}, m_finalImageBarriers, m_finalBufferBarriers);
+
+        commandList.End();
+    }
+
+    void RenderGraph::WorkerMain(uint32_t worker)
+    {
+        tracy::SetThreadName("Render graph worker");
+
+        uint64_t generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock lock(m_workerMutex);
+                m_workerCondition.wait(lock, [&]() { return m_stopWorkers || m_recordGeneration != generation; });
+                if (m_stopWorkers)
+                    return;
+                generation = m_recordGeneration;
+            }
+
+            // Graphs with fewer passes than workers leave the remaining workers idle.
+            if (worker >= m_recordWorkerCount)
+                continue;
+
+            RecordWorker(worker);
+
+            std::lock_guard lock(m_workerMutex);
+            if (--m_pendingWorkers == 0)
+                m_idleCondition.notify_all();
+        }
+    }
+
+    void RenderGraph::RecordPass(CommandList& commandList, const CompiledPass& compiledPass)
+    {
+        ZoneScoped;
+
+        const Pass& pass     = m_passes[compiledPass.pass];
+        uint32_t    usePoint = uint32_t(&compiledPass - m_compiledPasses.data());
+
+        commandList.PushDebugMarker(pass.name, 0xFF808080);
+
+        if (m_transientHeap)
+            commandList.AddAliasingBarriers(m_transientHeap, usePoint);
+        commandList.AddPipelineBarrier({}, compiledPass.imageBarriers, compiledPass.bufferBarriers);
+
+        bool isRenderPass = !pass.colorAttachments.empty() || pass.depthStencilAttachment.image != UINT32_MAX;
+        if (isRenderPass)
+        {
+            TL::Vector<ColorAttachment> colorAttachments;
+            for (const auto& attachment : pass.colorAttachments)
+            {
+                colorAttachments.push_back({
+                    .view       = m_images[attachment.image].image,
+                    .loadOp     = attachment.loadOp,
+                    .storeOp    = attachment.storeOp,
+                    .clearValue = attachment.clearValue,
+                });
+            }
+
+            DepthStencilAttachment depthStencilAttachment{};
+            if (const auto& attachment = pass.depthStencilAttachment; attachment.image != UINT32_MAX)
+            {
+                depthStencilAttachment = {
+                    .view           = m_images[attachment.image].image,
+                    .depthLoadOp    = attachment.loadOp,
+                    .depthStoreOp   = attachment.storeOp,
+                    .stencilLoadOp  = attachment.loadOp,
+                    .stencilStoreOp = attachment.storeOp,
+                    .clearValue     = attachment.clearValue.ds,
+                };
+            }
+
+            uint32_t sizeSource = pass.colorAttachments.empty() ? pass.depthStencilAttachment.image : pass.colorAttachments.front().image;
+            commandList.BeginRenderPass({
+                .size                   = m_images[sizeSource].size,
+                .offset                 = {},
+                .colorAttachments       = colorAttachments,
+                .depthStencilAttachment = depthStencilAttachment,
+            });
+        }
+
+        if (pass.execute)
+            pass.execute(commandList);
+
+        if (isRenderPass)
+            commandList.EndRenderPass();
+
+        commandList.PopDebugMarker();
+    }
+
+    Image* RenderGraph::GetImage(RGImage image) const
+    {
+        return m_images[image.index].image;
+    }
+
+    Buffer* RenderGraph::GetBuffer(RGBuffer buffer) const
+    {
+        return m_buffers[buffer.index].buffer;
+    }
+} // namespace RHI
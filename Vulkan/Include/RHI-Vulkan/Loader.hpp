@@ -17,10 +17,17 @@ namespace RHI
 
     struct ApplicationInfo
     {
-        const char* applicationName    = nullptr; // The name of the users application.
-        Version     applicationVersion = {};      // The version of the users application.
-        const char* engineName         = nullptr; // The version of the users application.
-        Version     engineVersion      = {};      // The version of the users application.
+        const char* applicationName      = nullptr;  // The name of the users application.
+        Version     applicationVersion   = {};       // The version of the users application.
+        const char* engineName           = nullptr;  // The version of the users application.
+        Version     engineVersion        = {};       // The version of the users application.
+        uint32_t    framesInFlight       = 2;        // Number of frames the CPU may record ahead of the GPU.
+        size_t      dynamicMemorySize    = 16 << 20; // Size of the ring backing Device::AllocateDynamic, shared by all frames in flight.
+        const char* pipelineCachePath    = nullptr;  // File the pipeline cache is loaded from and saved to, no persistence when null.
+        uint32_t    pipelineWorkerCount  = 0;        // Threads compiling async pipelines, 0 uses all hardware threads but one.
+        const char* pipelineManifestPath = nullptr;  // File compiled pipelines are recorded to for Device::PrecompilePipelines, no recording when null.
+        bool        useDescriptorBuffer  = false;    // Back bind groups with VK_EXT_descriptor_buffer when supported, see DeviceFeatures::hasDescriptorBuffer.
+        uint32_t    bindGroupCacheFrames = 0;        // Frames an unused bind group from Device::CreateCachedBindGroup is kept for, 0 disables the cache.
     };
 
     /// @brief Creates a new instance of RHI device, with vulkan backend implementation.
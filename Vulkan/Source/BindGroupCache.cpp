@@ -0,0 +1,152 @@
+#include "BindGroupCache.hpp"
+#include "Common.hpp"
+#include "Device.hpp"
+#include "Resources.hpp"
+
+#include <TL/Log.hpp>
+
+namespace RHI::Vulkan
+{
+    void BindGroupCache::Init(IDevice* device, uint32_t maxUnusedFrames)
+    {
+        m_device          = device;
+        m_maxUnusedFrames = maxUnusedFrames;
+    }
+
+    void BindGroupCache::Shutdown()
+    {
+        std::lock_guard lock(m_mutex);
+
+        for (auto& [key, entry] : m_entries)
+        {
+            if (entry.bindGroup->getRefCount() != 0)
+                TL::LogWarn("Cached bind group {} is still referenced at shutdown", entry.bindGroup->getName());
+            entry.bindGroup->Shutdown(m_device);
+            TL::destruct(entry.bindGroup);
+        }
+        m_entries.clear();
+        m_unused.clear();
+    }
+
+    uint64_t BindGroupCache::Hash(const BindGroupCreateInfo& createInfo, const BindGroupUpdateInfo& updateInfo)
+    {
+        // Resources are keyed by their unique id, an address may be reused by a resource created after one was destroyed.
+        uint64_t hash = TL::HashCombine(((IBindGroupLayout*)createInfo.layout)->uniqueId, createInfo.bindlessArrayCount);
+        auto     add  = [&hash](uint64_t value)
+        {
+            hash = TL::HashCombine(hash, value);
+        };
+
+        add(updateInfo.buffers.size());
+        for (const auto& [dstBinding, dstArrayElement, buffers] : updateInfo.buffers)
+        {
+            add(dstBinding);
+            add(dstArrayElement);
+            add(buffers.size());
+            for (const auto& buffer : buffers)
+            {
+                add(((IBuffer*)buffer.buffer)->uniqueId);
+                add(buffer.offset);
+                add(buffer.range);
+            }
+        }
+
+        add(updateInfo.images.size());
+        for (const auto& [dstBinding, dstArrayElement, images] : updateInfo.images)
+        {
+            add(dstBinding);
+            add(dstArrayElement);
+            add(images.size());
+            for (auto image : images)
+                add(((IImage*)image)->uniqueId);
+        }
+
+        add(updateInfo.samplers.size());
+        for (const auto& [dstBinding, dstArrayElement, samplers] : updateInfo.samplers)
+        {
+            add(dstBinding);
+            add(dstArrayElement);
+            add(samplers.size());
+            for (auto sampler : samplers)
+                add(((ISampler*)sampler)->uniqueId);
+        }
+
+        add(updateInfo.accelerationStructures.size());
+        for (const auto& [dstBinding, dstArrayElement, accelerationStructure] : updateInfo.accelerationStructures)
+        {
+            add(dstBinding);
+            add(dstArrayElement);
+            add(((IAccelerationStructure*)accelerationStructure)->uniqueId);
+        }
+        return hash;
+    }
+
+    IBindGroup* BindGroupCache::FindOrCreate(const BindGroupCreateInfo& createInfo, const BindGroupUpdateInfo& updateInfo)
+    {
+        uint64_t key = Hash(createInfo, updateInfo);
+
+        std::lock_guard lock(m_mutex);
+        if (auto it = m_entries.find(key); it != m_entries.end())
+        {
+            m_hitCount++;
+            it->second.bindGroup->addRef();
+            return it->second.bindGroup;
+        }
+
+        m_missCount++;
+        IBindGroup* bindGroup = TL::construct<IBindGroup>(createInfo.name ? TL::StringView(createInfo.name) : TL::StringView{});
+        if (auto result = bindGroup->Init(m_device, createInfo); IsError(result))
+        {
+            TL::destruct(bindGroup);
+            return nullptr;
+        }
+        bindGroup->Update(m_device, updateInfo);
+        bindGroup->cached   = true;
+        bindGroup->cacheKey = key;
+
+        m_entries[key] = {bindGroup, 0};
+        return bindGroup;
+    }
+
+    void BindGroupCache::Release(IBindGroup* bindGroup)
+    {
+        // Under the lock, so a concurrent FindOrCreate can not revive the group between the release and the queueing.
+        std::lock_guard lock(m_mutex);
+        if (!bindGroup->release())
+            return;
+
+        m_entries[bindGroup->cacheKey].releaseFrame = m_frame;
+        m_unused.push_back({bindGroup->cacheKey, m_frame});
+    }
+
+    void BindGroupCache::Evict()
+    {
+        std::lock_guard lock(m_mutex);
+
+        m_frame++;
+        while (!m_unused.empty() && m_unused.front().releaseFrame + m_maxUnusedFrames <= m_frame)
+        {
+            UnusedEntry unused = m_unused.front();
+            m_unused.pop_front();
+
+            // Revived since, or released again later and queued once more.
+            auto it = m_entries.find(unused.key);
+            if (it == m_entries.end() || it->second.bindGroup->getRefCount() != 0 || it->second.releaseFrame != unused.releaseFrame)
+                continue;
+
+            it->second.bindGroup->Shutdown(m_device);
+            TL::destruct(it->second.bindGroup);
+            m_entries.erase(it);
+        }
+    }
+
+    BindGroupCacheStats BindGroupCache::GetStats()
+    {
+        std::lock_guard lock(m_mutex);
+        return {
+            .hitCount       = m_hitCount,
+            .missCount      = m_missCount,
+            .bindGroupCount = uint32_t(m_entries.size()),
+        };
+    }
+} // namespace RHI::Vulkan
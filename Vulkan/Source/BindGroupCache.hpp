@@ -0,0 +1,62 @@
+#pragma once
+
+#include <RHI/RHI.h>
+
+#include <TL/Containers/Map.hpp>
+
+#include <deque>
+#include <mutex>
+
+namespace RHI::Vulkan
+{
+    class IDevice;
+    struct IBindGroup;
+
+    // Bind groups keyed by a hash of their layout and contents, identical requests share one reference counted group.
+    // Like pipelines, the 64-bit key is trusted. Groups whose last reference is released stay cached and are only
+    // destroyed once they were unused for the configured number of frames, least recently released first.
+    class BindGroupCache
+    {
+    public:
+        void                Init(IDevice* device, uint32_t maxUnusedFrames);
+        void                Shutdown();
+
+        bool                IsEnabled() const { return m_maxUnusedFrames != 0; }
+
+        static uint64_t     Hash(const BindGroupCreateInfo& createInfo, const BindGroupUpdateInfo& updateInfo);
+
+        // Returns the group stored for these contents with an added reference, otherwise creates and writes a new one.
+        IBindGroup*         FindOrCreate(const BindGroupCreateInfo& createInfo, const BindGroupUpdateInfo& updateInfo);
+        void                Release(IBindGroup* bindGroup);
+
+        // Advances the frame counter, called once per EndFrame. Evicted groups go through the delete queue, which
+        // keeps them alive until the GPU retired every submission that could still reference them.
+        void                Evict();
+
+        BindGroupCacheStats GetStats();
+
+    private:
+        struct UnusedEntry
+        {
+            uint64_t key;
+            uint64_t releaseFrame;
+        };
+
+        struct Entry
+        {
+            IBindGroup* bindGroup;
+            // Frame of the last release, newer than an UnusedEntry's when the group was revived in between.
+            uint64_t    releaseFrame;
+        };
+
+        IDevice*                 m_device          = nullptr;
+        uint32_t                 m_maxUnusedFrames = 0;
+        uint64_t                 m_frame           = 0;
+        std::mutex               m_mutex;
+        TL::Map<uint64_t, Entry> m_entries;
+        // Released groups in release order, entries revived since are skipped when they reach the front.
+        std::deque<UnusedEntry>  m_unused;
+        uint64_t                 m_hitCount  = 0;
+        uint64_t                 m_missCount = 0;
+    };
+} // namespace RHI::Vulkan
@@ -0,0 +1,230 @@
+#include "BindlessHeap.hpp"
+#include "Common.hpp"
+#include "Device.hpp"
+#include "Resources.hpp"
+
+#include <TL/Log.hpp>
+
+#include <algorithm>
+
+namespace RHI::Vulkan
+{
+    ResultCode BindlessHeap::Init(IDevice* device)
+    {
+        m_device = device;
+
+        VkPhysicalDeviceVulkan12Properties properties12{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES, .pNext = nullptr};
+        VkPhysicalDeviceProperties2        properties{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &properties12};
+        vkGetPhysicalDeviceProperties2(device->m_physicalDevice, &properties);
+
+        // Descriptor buffers have no update-after-bind pools, so the regular per stage limits apply.
+        bool        useDescriptorBuffer = device->GetFeatures().hasDescriptorBuffer;
+        const auto& limits              = properties.properties.limits;
+        m_slots[Images].capacity        = std::min(MaxImages, useDescriptorBuffer ? limits.maxPerStageDescriptorSampledImages : properties12.maxPerStageDescriptorUpdateAfterBindSampledImages);
+        m_slots[Buffers].capacity       = std::min(MaxBuffers, useDescriptorBuffer ? limits.maxPerStageDescriptorStorageBuffers : properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers);
+        m_slots[Samplers].capacity      = std::min(MaxSamplers, useDescriptorBuffer ? limits.maxPerStageDescriptorSamplers : properties12.maxPerStageDescriptorUpdateAfterBindSamplers);
+
+        TL::Flags<ShaderStage> stages = ShaderStage::AllStages;
+        if (device->GetFeatures().hasMeshShaders)
+            stages |= ShaderStage::Mesh | ShaderStage::Amplification;
+        if (device->GetFeatures().hasRaytracing)
+            stages |= ShaderStage::RayGen | ShaderStage::RayIntersect | ShaderStage::RayAnyHit | ShaderStage::RayClosestHit | ShaderStage::RayMiss | ShaderStage::RayCallable;
+
+        ShaderBinding bindings[BindingCount] = {};
+        bindings[Images]                     = {.type = BindingType::SampledImage, .access = Access::Read, .arrayCount = m_slots[Images].capacity, .stages = stages};
+        bindings[Buffers]                    = {.type = BindingType::StorageBuffer, .access = Access::ReadWrite, .arrayCount = m_slots[Buffers].capacity, .stages = stages};
+        bindings[Samplers]                   = {.type = BindingType::Sampler, .access = Access::Read, .arrayCount = m_slots[Samplers].capacity, .stages = stages};
+
+        BindGroupLayoutCreateInfo layoutCI{
+            .name     = "Bindless heap",
+            .pushable = false,
+            .bindings = bindings,
+        };
+        m_layout = TL::construct<IBindGroupLayout>(layoutCI.name);
+        if (auto result = m_layout->Init(device, layoutCI, true); IsError(result))
+            return result;
+
+        m_bindGroup                  = TL::construct<IBindGroup>(layoutCI.name);
+        m_bindGroup->bindGroupLayout = m_layout;
+
+        if (useDescriptorBuffer)
+            return device->m_bindGroupAllocator.InitBindGroup(m_bindGroup, m_layout, 0);
+
+        VkDescriptorPoolSize poolSizes[] = {
+            {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, m_slots[Images].capacity},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_slots[Buffers].capacity},
+            {VK_DESCRIPTOR_TYPE_SAMPLER, m_slots[Samplers].capacity},
+        };
+        VkDescriptorPoolCreateInfo poolCI{
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .pNext         = nullptr,
+            .flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+            .maxSets       = 1,
+            .poolSizeCount = sizeof(poolSizes) / sizeof(VkDescriptorPoolSize),
+            .pPoolSizes    = poolSizes,
+        };
+        VulkanResult result = vkCreateDescriptorPool(device->m_device, &poolCI, nullptr, &m_descriptorPool);
+        if (result.IsError())
+            return result;
+
+        VkDescriptorSetAllocateInfo allocateInfo{
+            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .pNext              = nullptr,
+            .descriptorPool     = m_descriptorPool,
+            .descriptorSetCount = 1,
+            .pSetLayouts        = &m_layout->handle,
+        };
+        result = vkAllocateDescriptorSets(device->m_device, &allocateInfo, &m_bindGroup->descriptorSet);
+        if (result.IsSuccess())
+            device->SetDebugName(m_bindGroup->descriptorSet, layoutCI.name);
+        return result;
+    }
+
+    void BindlessHeap::Shutdown(IDevice* device)
+    {
+        if (m_bindGroup)
+        {
+            // Destroying the pool frees the heap's set.
+            if (m_descriptorPool != VK_NULL_HANDLE)
+                vkDestroyDescriptorPool(device->m_device, m_descriptorPool, nullptr);
+            else
+                device->m_bindGroupAllocator.ShutdownBindGroup(m_bindGroup);
+            TL::destruct(m_bindGroup);
+            m_bindGroup = nullptr;
+        }
+
+        if (m_layout)
+        {
+            m_layout->Shutdown(device);
+            TL::destruct(m_layout);
+            m_layout = nullptr;
+        }
+    }
+
+    uint32_t BindlessHeap::RegisterImage(Image* image)
+    {
+        std::lock_guard lock(m_mutex);
+
+        uint32_t index = AllocateSlot(Images);
+        if (index == InvalidBindlessIndex)
+            return index;
+
+        BindGroupImagesUpdateInfo imageInfo{
+            .dstBinding      = Images,
+            .dstArrayElement = index,
+            .images          = {&image, 1},
+        };
+        Write({.images = {&imageInfo, 1}});
+        return index;
+    }
+
+    uint32_t BindlessHeap::RegisterBuffer(Buffer* buffer)
+    {
+        std::lock_guard lock(m_mutex);
+
+        uint32_t index = AllocateSlot(Buffers);
+        if (index == InvalidBindlessIndex)
+            return index;
+
+        BufferBindingInfo bufferBinding{
+            .buffer = buffer,
+            .offset = 0,
+            .range  = uint32_t(std::min<VkDeviceSize>(((IBuffer*)buffer)->size, UINT32_MAX)),
+        };
+        BindGroupBuffersUpdateInfo bufferInfo{
+            .dstBinding      = Buffers,
+            .dstArrayElement = index,
+            .buffers         = {&bufferBinding, 1},
+        };
+        Write({.buffers = {&bufferInfo, 1}});
+        return index;
+    }
+
+    uint32_t BindlessHeap::RegisterSampler(Sampler* sampler)
+    {
+        std::lock_guard lock(m_mutex);
+
+        uint32_t index = AllocateSlot(Samplers);
+        if (index == InvalidBindlessIndex)
+            return index;
+
+        BindGroupSamplersUpdateInfo samplerInfo{
+            .dstBinding      = Samplers,
+            .dstArrayElement = index,
+            .samplers        = {&sampler, 1},
+        };
+        Write({.samplers = {&samplerInfo, 1}});
+        return index;
+    }
+
+    void BindlessHeap::Unregister(Binding binding, uint32_t index)
+    {
+        std::lock_guard lock(m_mutex);
+
+        // The descriptor is left as is, partially bound arrays tolerate it as long as shaders stop reading it.
+        TL_ASSERT(index < m_slots[binding].head, "Bindless index was never registered");
+        m_slots[binding].pending.push_back(index);
+    }
+
+    void BindlessHeap::Retire(uint64_t timelineValue)
+    {
+        std::lock_guard lock(m_mutex);
+
+        for (Slots& slots : m_slots)
+        {
+            for (uint32_t index : slots.pending)
+                slots.retired.push_back({timelineValue, index});
+            slots.pending.clear();
+        }
+    }
+
+    void BindlessHeap::Reclaim(uint64_t completedValue)
+    {
+        std::lock_guard lock(m_mutex);
+
+        for (Slots& slots : m_slots)
+        {
+            // Retired in timeline order, so the released slots are a prefix.
+            size_t count = 0;
+            while (count < slots.retired.size() && slots.retired[count].timelineValue <= completedValue)
+                slots.freeList.push_back(slots.retired[count++].index);
+            slots.retired.erase(slots.retired.begin(), slots.retired.begin() + count);
+        }
+    }
+
+    void BindlessHeap::Write(const BindGroupUpdateInfo& updateInfo)
+    {
+        if (m_device->GetFeatures().hasDescriptorBuffer)
+        {
+            m_device->m_bindGroupAllocator.WriteBindGroup(m_bindGroup, updateInfo);
+            return;
+        }
+
+        m_arena.reset();
+        DescriptorSetWriter writer(m_device, m_bindGroup->descriptorSet, m_layout, m_arena);
+        for (auto [dstBinding, dstArrayElement, images] : updateInfo.images)
+            writer.BindImages(dstBinding, dstArrayElement, images);
+        for (auto [dstBinding, dstArrayElement, buffers] : updateInfo.buffers)
+            writer.BindBuffers(dstBinding, dstArrayElement, buffers);
+        for (auto [dstBinding, dstArrayElement, samplers] : updateInfo.samplers)
+            writer.BindSamplers(dstBinding, dstArrayElement, samplers);
+        vkUpdateDescriptorSets(m_device->m_device, (uint32_t)writer.GetWrites().size(), writer.GetWrites().data(), 0, nullptr);
+    }
+
+    uint32_t BindlessHeap::AllocateSlot(Binding binding)
+    {
+        Slots& slots = m_slots[binding];
+        if (!slots.freeList.empty())
+        {
+            uint32_t index = slots.freeList.back();
+            slots.freeList.pop_back();
+            return index;
+        }
+
+        if (slots.head < slots.capacity)
+            return slots.head++;
+
+        TL::LogError("Bindless heap is full, all {} slots of binding {} are in use", slots.capacity, (uint32_t)binding);
+        return InvalidBindlessIndex;
+    }
+} // namespace RHI::Vulkan
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <RHI/RHI.h>
+
+#include <TL/Allocator/Arena.hpp>
+#include <TL/Containers/Vector.hpp>
+
+#include <mutex>
+
+#include <volk.h>
+
+namespace RHI::Vulkan
+{
+    class IDevice;
+    struct IBindGroup;
+    struct IBindGroupLayout;
+
+    // Device owned bind group with one partially bound array per resource kind. Slots are handed out as stable
+    // indices, unregistered slots are retired with the frame's timeline value and recycled once it was reached.
+    class BindlessHeap
+    {
+    public:
+        enum Binding : uint32_t
+        {
+            Images,
+            Buffers,
+            Samplers,
+            BindingCount,
+        };
+
+        static constexpr uint32_t MaxImages   = 64 * 1024;
+        static constexpr uint32_t MaxBuffers  = 64 * 1024;
+        static constexpr uint32_t MaxSamplers = 2 * 1024;
+
+        ResultCode        Init(IDevice* device);
+        void              Shutdown(IDevice* device);
+
+        IBindGroupLayout* GetLayout() const { return m_layout; }
+        IBindGroup*       GetBindGroup() const { return m_bindGroup; }
+
+        // Return InvalidBindlessIndex when the matching array is full. Safe to call from any thread.
+        uint32_t          RegisterImage(Image* image);
+        uint32_t          RegisterBuffer(Buffer* buffer);
+        uint32_t          RegisterSampler(Sampler* sampler);
+        void              Unregister(Binding binding, uint32_t index);
+
+        // Tags every slot unregistered since the previous call with the timeline value that releases them.
+        void              Retire(uint64_t timelineValue);
+        void              Reclaim(uint64_t completedValue);
+
+    private:
+        struct RetiredSlot
+        {
+            uint64_t timelineValue;
+            uint32_t index;
+        };
+
+        struct Slots
+        {
+            uint32_t                capacity = 0;
+            // Slots below this were handed out at least once, higher ones were never used.
+            uint32_t                head     = 0;
+            TL::Vector<uint32_t>    freeList;
+            TL::Vector<uint32_t>    pending;
+            TL::Vector<RetiredSlot> retired;
+        };
+
+        uint32_t AllocateSlot(Binding binding);
+        // Writes the heap's descriptors, expects m_mutex to be held.
+        void     Write(const BindGroupUpdateInfo& updateInfo);
+
+        IDevice*          m_device         = nullptr;
+        IBindGroupLayout* m_layout         = nullptr;
+        IBindGroup*       m_bindGroup      = nullptr;
+        // Only used without descriptor buffers, the heap outgrows the shared bind group pool.
+        VkDescriptorPool  m_descriptorPool = VK_NULL_HANDLE;
+        std::mutex        m_mutex;
+        // Scratch for descriptor set writes, registration runs outside the frame so the device arena can not be used.
+        TL::Arena         m_arena;
+        Slots             m_slots[BindingCount];
+    };
+} // namespace RHI::Vulkan
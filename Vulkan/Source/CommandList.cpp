@@ -226,6 +226,38 @@ namespace RHI::Vulkan
         };
     }
 
+    // Resolves the queue family ownership transfer of a barrier recorded on a list targeting recordingQueue.
+    // The release half keeps only the source scope and the acquire half only the destination scope.
+    // Returns false when the barrier must not be recorded at all.
+    inline static bool ResolveQueueOwnershipTransfer(IDevice* device, QueueType recordingQueue, QueueType srcQueue, QueueType dstQueue, BarrierStage& src, BarrierStage& dst)
+    {
+        if (srcQueue == QueueType::Count || dstQueue == QueueType::Count)
+            return true;
+
+        // Within one family no ownership changes, the release half does the whole transition and the semaphore
+        // wait between the queues orders the acquire side. Recording it again would repeat the layout transition.
+        uint32_t srcFamilyIndex = device->m_queue[(uint32_t)srcQueue].m_familyIndex;
+        uint32_t dstFamilyIndex = device->m_queue[(uint32_t)dstQueue].m_familyIndex;
+        if (srcFamilyIndex == dstFamilyIndex)
+            return recordingQueue == srcQueue;
+
+        src.queueFamilyIndex = srcFamilyIndex;
+        dst.queueFamilyIndex = dstFamilyIndex;
+
+        if (recordingQueue == srcQueue)
+        {
+            dst.stageMask  = VK_PIPELINE_STAGE_2_NONE;
+            dst.accessMask = VK_ACCESS_2_NONE;
+        }
+        else
+        {
+            TL_ASSERT(recordingQueue == dstQueue, "Ownership transfer barrier recorded on a queue that is neither its source nor its destination");
+            src.stageMask  = VK_PIPELINE_STAGE_2_NONE;
+            src.accessMask = VK_ACCESS_2_NONE;
+        }
+        return true;
+    }
+
     inline static VkStridedDeviceAddressRegionKHR convertStridedDeviceAddressRegion(const StridedDeviceAddressRegion& r)
     {
         // NOTE: DispatchRaysInfo carries no SBT buffer handle, so `offset` is the region's absolute
@@ -244,6 +276,7 @@ namespace RHI::Vulkan
     ResultCode ICommandPool::Init(IDevice* device, const CommandPoolCreateInfo& createInfo)
     {
         m_device      = device;
+        m_queueType   = createInfo.queue;
         IQueue* queue = (IQueue*)device->GetQueue(createInfo.queue);
 
         VkCommandPoolCreateInfo poolInfo = {
@@ -261,17 +294,31 @@ namespace RHI::Vulkan
 
     void ICommandPool::Shutdown(IDevice* device)
     {
+        for (auto commandList : m_commandLists)
+            TL::destruct(commandList);
+        m_commandLists.clear();
+        m_availableIndex = 0;
+
         vkDestroyCommandPool(device->m_device, m_commandPool, nullptr);
     }
 
     void ICommandPool::Reset()
     {
-        vkResetCommandPool(m_device->m_device, m_commandPool, VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT);
-        m_arena.reset();
+        // Keep the pool memory around, the same command buffers are recorded again next time.
+        vkResetCommandPool(m_device->m_device, m_commandPool, 0);
+        m_scratchArena.reset();
+        m_availableIndex = 0;
     }
 
     CommandList* ICommandPool::Allocate()
     {
+        // Every command list past m_availableIndex was reset with the pool and can be handed out again.
+        if (m_availableIndex < m_commandLists.size())
+        {
+            m_stats.reusedCount++;
+            return m_commandLists[m_availableIndex++];
+        }
+
         VkCommandBufferAllocateInfo allocateInfo = {
             VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
             nullptr,
@@ -279,13 +326,23 @@ namespace RHI::Vulkan
             VK_COMMAND_BUFFER_LEVEL_PRIMARY,
             1,
         };
-        ICommandList* commandList = TL::constructFrom<ICommandList>(&m_arena);
+        ICommandList* commandList = TL::construct<ICommandList>();
         commandList->m_device     = m_device;
+        commandList->m_pool       = this;
         VulkanResult result       = vkAllocateCommandBuffers(m_device->m_device, &allocateInfo, &commandList->m_commandBuffer);
         TL_ASSERT(result.IsSuccess());
+
+        m_commandLists.push_back(commandList);
+        m_availableIndex = (uint32_t)m_commandLists.size();
+        m_stats.allocatedCount++;
         return commandList;
     }
 
+    CommandPoolStats ICommandPool::GetStats() const
+    {
+        return m_stats;
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////
     /// CommandList
     //////////////////////////////////////////////////////////////////////////////////////////
@@ -316,6 +373,44 @@ namespace RHI::Vulkan
             .pInheritanceInfo = nullptr,
         };
         vkBeginCommandBuffer(m_commandBuffer, &beginInfo);
+
+        // Scratch allocations never outlive the call that made them, lists recorded again and again from a pool
+        // that is never reset would otherwise grow it without bound.
+        m_pool->m_scratchArena.reset();
+
+        // Every bind group lives in the one descriptor buffer, so it is bound once per recording.
+        if (m_device->GetFeatures().hasDescriptorBuffer && m_pool->m_queueType != QueueType::Transfer)
+        {
+            const BindGroupAllocator& bindGroupAllocator = m_device->m_bindGroupAllocator;
+            VkDescriptorBufferBindingPushDescriptorBufferHandleEXT pushDescriptorBuffer{
+                .sType  = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_PUSH_DESCRIPTOR_BUFFER_HANDLE_EXT,
+                .pNext  = nullptr,
+                .buffer = bindGroupAllocator.m_descriptorBuffer,
+            };
+            VkDescriptorBufferBindingInfoEXT bindingInfo{
+                .sType   = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                .pNext   = m_device->m_descriptorBufferProperties.bufferlessPushDescriptors ? nullptr : &pushDescriptorBuffer,
+                .address = bindGroupAllocator.m_descriptorBufferAddress,
+                .usage   = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT,
+            };
+            if (!m_device->m_descriptorBufferProperties.bufferlessPushDescriptors)
+                bindingInfo.usage |= VK_BUFFER_USAGE_PUSH_DESCRIPTORS_DESCRIPTOR_BUFFER_BIT_EXT;
+            vkCmdBindDescriptorBuffersEXT(m_commandBuffer, 1, &bindingInfo);
+        }
+
+        // Command lists are recycled by their pool, drop any state left from the previous recording.
+        m_pipelineLayout          = nullptr;
+        m_pipelineBindPoint       = VK_PIPELINE_BIND_POINT_MAX_ENUM;
+        m_bindlessHeapLayout      = nullptr;
+        m_bindlessHeapBindPoint   = VK_PIPELINE_BIND_POINT_MAX_ENUM;
+        m_hasVertexBuffer         = false;
+        m_hasIndexBuffer          = false;
+        m_isGraphicsPipelineBound = false;
+        m_isComputePipelineBound  = false;
+        m_hasViewportSet          = false;
+        m_hasScissorSet           = false;
+        m_areShadersBound         = false;
+        ResetDynamicState();
     }
 
     void ICommandList::End()
@@ -384,9 +479,9 @@ namespace RHI::Vulkan
         if (barriers.empty() && imageBarriers.empty() && bufferBarriers.empty())
             return;
 
-        TL::Vector<VkMemoryBarrier2>       vmemoryBarriers{m_device->m_arena};
-        TL::Vector<VkBufferMemoryBarrier2> vbufferBarriers{m_device->m_arena};
-        TL::Vector<VkImageMemoryBarrier2>  vimageBarriers{m_device->m_arena};
+        TL::Vector<VkMemoryBarrier2>       vmemoryBarriers{m_pool->m_scratchArena};
+        TL::Vector<VkBufferMemoryBarrier2> vbufferBarriers{m_pool->m_scratchArena};
+        TL::Vector<VkImageMemoryBarrier2>  vimageBarriers{m_pool->m_scratchArena};
         vmemoryBarriers.reserve(barriers.size());
         vbufferBarriers.reserve(bufferBarriers.size());
         vimageBarriers.reserve(imageBarriers.size());
@@ -410,8 +505,13 @@ namespace RHI::Vulkan
         {
             auto image = (IImage*)(imageBarrier.image);
 
-            auto [srcStageMask, srcAccessMask, srcLayout, srcQueueFamilyIndex] = ConvertBarrierState(imageBarrier.srcState);
-            auto [dstStageMask, dstAccessMask, dstLayout, dstQueueFamilyIndex] = ConvertBarrierState(imageBarrier.dstState);
+            BarrierStage srcStage = ConvertBarrierState(imageBarrier.srcState);
+            BarrierStage dstStage = ConvertBarrierState(imageBarrier.dstState);
+            if (!ResolveQueueOwnershipTransfer(m_device, m_pool->m_queueType, imageBarrier.srcQueue, imageBarrier.dstQueue, srcStage, dstStage))
+                continue;
+
+            auto [srcStageMask, srcAccessMask, srcLayout, srcQueueFamilyIndex] = srcStage;
+            auto [dstStageMask, dstAccessMask, dstLayout, dstQueueFamilyIndex] = dstStage;
 
             // A default (All()) subresource means "the whole image"; resolve it to the image's
             // actual range so the barrier carries real mip/array counts.
@@ -439,8 +539,13 @@ namespace RHI::Vulkan
         {
             auto buffer = (IBuffer*)(bufferBarrier.buffer);
 
-            auto [srcStageMask, srcAccessMask, srcLayout, srcQueueFamilyIndex] = ConvertBarrierState(bufferBarrier.srcState);
-            auto [dstStageMask, dstAccessMask, dstLayout, dstQueueFamilyIndex] = ConvertBarrierState(bufferBarrier.dstState);
+            BarrierStage srcStage = ConvertBarrierState(bufferBarrier.srcState);
+            BarrierStage dstStage = ConvertBarrierState(bufferBarrier.dstState);
+            if (!ResolveQueueOwnershipTransfer(m_device, m_pool->m_queueType, bufferBarrier.srcQueue, bufferBarrier.dstQueue, srcStage, dstStage))
+                continue;
+
+            auto [srcStageMask, srcAccessMask, srcLayout, srcQueueFamilyIndex] = srcStage;
+            auto [dstStageMask, dstAccessMask, dstLayout, dstQueueFamilyIndex] = dstStage;
 
             vbufferBarriers.push_back({
                 .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
@@ -472,11 +577,25 @@ namespace RHI::Vulkan
         vkCmdPipelineBarrier2(m_commandBuffer, &dependencyInfo);
     }
 
+    void ICommandList::AddAliasingBarriers(TransientHeap* _heap, uint32_t usePoint)
+    {
+        auto heap = (ITransientHeap*)_heap;
+        if (!std::binary_search(heap->aliasingUsePoints.begin(), heap->aliasingUsePoints.end(), usePoint))
+            return;
+
+        // The last accesses of the previous occupants are not tracked, order all prior work against the new resources.
+        BarrierInfo barrier{
+            .srcState = {.stage = PipelineStage::AllCommands, .access = Access::Write},
+            .dstState = {.stage = PipelineStage::AllCommands, .access = Access::Read | Access::Write},
+        };
+        AddPipelineBarrier({&barrier, 1}, {}, {});
+    }
+
     void ICommandList::BeginRenderPass(const RenderPassBeginInfo& beginInfo)
     {
         ZoneScoped;
 
-        TL::Vector<VkRenderingAttachmentInfo>   colorAttachments{m_device->m_arena};
+        TL::Vector<VkRenderingAttachmentInfo>   colorAttachments{m_pool->m_scratchArena};
         TL::Optional<VkRenderingAttachmentInfo> depthAttachment{};
         TL::Optional<VkRenderingAttachmentInfo> stencilAttachment{};
 
@@ -600,7 +719,7 @@ namespace RHI::Vulkan
     {
         ZoneScoped;
 
-        TL::Vector<VkCommandBuffer> commandBuffers{m_device->m_arena};
+        TL::Vector<VkCommandBuffer> commandBuffers{m_pool->m_scratchArena};
         commandBuffers.reserve(commandLists.size());
 
         for (const auto* commandList : commandLists)
@@ -618,6 +737,7 @@ namespace RHI::Vulkan
 
         m_pipelineLayout    = (PipelineLayout*)pipelineLayout;
         m_pipelineBindPoint = bindPoint == BindPoint::Graphics ? VK_PIPELINE_BIND_POINT_GRAPHICS : VK_PIPELINE_BIND_POINT_COMPUTE;
+        BindBindlessHeap();
     }
 
     void ICommandList::SetPushConstants(BindPoint bindPoint, uint32_t offset, TL::Block content)
@@ -636,7 +756,7 @@ namespace RHI::Vulkan
 
         IPipelineLayout*    pipelineLayout = (IPipelineLayout*)m_pipelineLayout;
         IBindGroupLayout*   groupLayout    = pipelineLayout->bindGroupLayouts[firstGroup];
-        DescriptorSetWriter writer{m_device, VK_NULL_HANDLE, groupLayout, m_device->m_arena};
+        DescriptorSetWriter writer{m_device, VK_NULL_HANDLE, groupLayout, m_pool->m_scratchArena};
         for (const auto& updateInfo : updateInfos)
         {
             for (auto [dstBindings, dstArrayelements, buffers] : updateInfo.buffers)
@@ -678,8 +798,23 @@ namespace RHI::Vulkan
         IPipelineLayout*    pipelineLayout = (IPipelineLayout*)m_pipelineLayout;
         VkPipelineBindPoint vkBindPoint    = convertBindPoint(bindPoint);
 
-        TL::Vector<VkDescriptorSet> descriptorSets{m_device->m_arena};
-        TL::Vector<uint32_t>        dynamicOffsets{m_device->m_arena};
+        if (m_device->GetFeatures().hasDescriptorBuffer)
+        {
+            // All groups come from buffer 0, binding them only sets their offsets.
+            TL::Vector<uint32_t>     bufferIndices{m_pool->m_scratchArena};
+            TL::Vector<VkDeviceSize> offsets{m_pool->m_scratchArena};
+            for (const auto& bindingInfo : bindGroups)
+            {
+                TL_ASSERT(bindingInfo.dynamicOffsets.empty(), "Dynamic offsets are not supported with descriptor buffers");
+                bufferIndices.push_back(0);
+                offsets.push_back(((IBindGroup*)bindingInfo.bindGroup)->descriptorOffset);
+            }
+            vkCmdSetDescriptorBufferOffsetsEXT(m_commandBuffer, vkBindPoint, pipelineLayout->handle, 0, (uint32_t)offsets.size(), bufferIndices.data(), offsets.data());
+            return;
+        }
+
+        TL::Vector<VkDescriptorSet> descriptorSets{m_pool->m_scratchArena};
+        TL::Vector<uint32_t>        dynamicOffsets{m_pool->m_scratchArena};
 
         for (const auto& bindingInfo : bindGroups)
         {
@@ -705,12 +840,28 @@ namespace RHI::Vulkan
         }
 
         m_isGraphicsPipelineBound       = true;
+        m_areShadersBound               = false;
         IGraphicsPipeline* pipeline     = (IGraphicsPipeline*)(pipelineState);
         m_pipelineLayout                = pipeline->layout;
         IPipelineLayout* pipelineLayout = (IPipelineLayout*)m_pipelineLayout;
         m_pipelineBindPoint             = VK_PIPELINE_BIND_POINT_GRAPHICS;
 
-        vkCmdBindPipeline(m_commandBuffer, m_pipelineBindPoint, pipeline->handle);
+        vkCmdBindPipeline(m_commandBuffer, m_pipelineBindPoint, pipeline->GetBindHandle());
+        BindBindlessHeap();
+
+        // Binding a pipeline with static state invalidates the matching dynamic state.
+        const auto& dynamicState = pipeline->dynamicState;
+        if (!dynamicState.enabled)
+        {
+            ResetDynamicState();
+            return;
+        }
+
+        SetCullMode(dynamicState.cullMode);
+        SetFrontFace(dynamicState.frontFace);
+        SetDepthState(dynamicState.depthStencilState);
+        if (m_device->GetFeatures().hasDynamicColorBlendEnable && dynamicState.colorAttachmentCount != 0)
+            SetColorBlendEnable(0, {dynamicState.blendEnables, dynamicState.colorAttachmentCount});
     }
 
     void ICommandList::BindComputePipeline(const ComputePipeline* pipelineState)
@@ -730,6 +881,7 @@ namespace RHI::Vulkan
         m_pipelineBindPoint             = VK_PIPELINE_BIND_POINT_COMPUTE;
 
         vkCmdBindPipeline(m_commandBuffer, m_pipelineBindPoint, pipeline->handle);
+        BindBindlessHeap();
     }
 
     void ICommandList::BindRayTracingPipeline(const RayTracingPipeline* pipelineState)
@@ -744,6 +896,72 @@ namespace RHI::Vulkan
         m_pipelineBindPoint           = VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR;
 
         vkCmdBindPipeline(m_commandBuffer, m_pipelineBindPoint, pipeline->handle);
+        BindBindlessHeap();
+    }
+
+    void ICommandList::BindShaders(const ShaderObject* _shaderObject)
+    {
+        ZoneScoped;
+
+        auto shaderObject = (const IShaderObject*)_shaderObject;
+        m_pipelineLayout  = shaderObject->layout;
+
+        if (shaderObject->IsCompute())
+        {
+            m_isComputePipelineBound = true;
+            m_pipelineBindPoint      = VK_PIPELINE_BIND_POINT_COMPUTE;
+            vkCmdBindShadersEXT(m_commandBuffer, 1, shaderObject->stages, shaderObject->shaders);
+            BindBindlessHeap();
+            return;
+        }
+
+        m_isGraphicsPipelineBound = true;
+        m_areShadersBound         = true;
+        m_pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+        // Every graphics stage the device enabled is bound, stages the object does not provide are unbound.
+        VkShaderStageFlagBits stages[]   = {VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_TASK_BIT_EXT, VK_SHADER_STAGE_MESH_BIT_EXT};
+        VkShaderEXT           shaders[4] = {};
+        uint32_t              stageCount = m_device->GetFeatures().hasMeshShaders ? 4 : 2;
+        for (uint32_t i = 0; i < shaderObject->stageCount; ++i)
+        {
+            auto it = std::find(stages, stages + stageCount, shaderObject->stages[i]);
+            TL_ASSERT(it != stages + stageCount);
+            shaders[it - stages] = shaderObject->shaders[i];
+        }
+        vkCmdBindShadersEXT(m_commandBuffer, stageCount, stages, shaders);
+        BindBindlessHeap();
+
+        // Shader objects have no baked state, record all of it. The values match what a pipeline would bake.
+        VkSampleMask sampleMask = UINT32_MAX;
+        vkCmdSetVertexInputEXT(m_commandBuffer, (uint32_t)shaderObject->vertexBindings.size(), shaderObject->vertexBindings.data(), (uint32_t)shaderObject->vertexAttributes.size(), shaderObject->vertexAttributes.data());
+        vkCmdSetPrimitiveTopology(m_commandBuffer, shaderObject->topology);
+        vkCmdSetPrimitiveRestartEnable(m_commandBuffer, VK_FALSE);
+        vkCmdSetRasterizerDiscardEnable(m_commandBuffer, VK_FALSE);
+        vkCmdSetPolygonModeEXT(m_commandBuffer, shaderObject->polygonMode);
+        vkCmdSetLineWidth(m_commandBuffer, shaderObject->lineWidth);
+        vkCmdSetDepthBiasEnable(m_commandBuffer, VK_FALSE);
+        vkCmdSetDepthBoundsTestEnable(m_commandBuffer, VK_FALSE);
+        const auto& stencil = shaderObject->stencilState;
+        vkCmdSetStencilOp(m_commandBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, stencil.failOp, stencil.passOp, stencil.depthFailOp, stencil.compareOp);
+        vkCmdSetStencilCompareMask(m_commandBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, stencil.compareMask);
+        vkCmdSetStencilWriteMask(m_commandBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, stencil.writeMask);
+        vkCmdSetStencilReference(m_commandBuffer, VK_STENCIL_FACE_FRONT_AND_BACK, stencil.reference);
+        vkCmdSetRasterizationSamplesEXT(m_commandBuffer, shaderObject->sampleCount);
+        vkCmdSetSampleMaskEXT(m_commandBuffer, shaderObject->sampleCount, &sampleMask);
+        vkCmdSetAlphaToCoverageEnableEXT(m_commandBuffer, VK_FALSE);
+        vkCmdSetBlendConstants(m_commandBuffer, shaderObject->blendConstants);
+
+        const auto& dynamicState = shaderObject->dynamicState;
+        SetCullMode(dynamicState.cullMode);
+        SetFrontFace(dynamicState.frontFace);
+        SetDepthState(dynamicState.depthStencilState);
+        if (dynamicState.colorAttachmentCount != 0)
+        {
+            SetColorBlendEnable(0, {dynamicState.blendEnables, dynamicState.colorAttachmentCount});
+            vkCmdSetColorBlendEquationEXT(m_commandBuffer, 0, dynamicState.colorAttachmentCount, shaderObject->blendEquations.data());
+            vkCmdSetColorWriteMaskEXT(m_commandBuffer, 0, dynamicState.colorAttachmentCount, shaderObject->writeMasks.data());
+        }
     }
 
     void ICommandList::SetViewport(float offsetX, float offsetY, float width, float height, float minDepth, float maxDepth)
@@ -758,7 +976,7 @@ namespace RHI::Vulkan
             .minDepth = minDepth,
             .maxDepth = maxDepth,
         };
-        vkCmdSetViewport(m_commandBuffer, 0, 1, &vkViewport);
+        vkCmdSetViewportWithCount(m_commandBuffer, 1, &vkViewport);
         m_hasViewportSet = true;
     }
 
@@ -770,10 +988,109 @@ namespace RHI::Vulkan
             .offset = {offsetX, offsetY},
             .extent = {width, height},
         };
-        vkCmdSetScissor(m_commandBuffer, 0, 1, &vkScissor);
+        vkCmdSetScissorWithCount(m_commandBuffer, 1, &vkScissor);
         m_hasScissorSet = true;
     }
 
+    // Records value into cached, returns false when it already held it.
+    inline static bool UpdateDynamicState(uint32_t& cached, uint32_t value)
+    {
+        if (cached == value)
+            return false;
+        cached = value;
+        return true;
+    }
+
+    void ICommandList::ResetDynamicState()
+    {
+        static_assert(sizeof(DynamicStateCache::blendEnables) / sizeof(uint32_t) == GraphicsPipelineDynamicState::MaxColorAttachments);
+        std::fill_n((uint32_t*)&m_dynamicState, sizeof(DynamicStateCache) / sizeof(uint32_t), UnknownDynamicState);
+    }
+
+    void ICommandList::BindBindlessHeap()
+    {
+        auto pipelineLayout = (IPipelineLayout*)m_pipelineLayout;
+        if (pipelineLayout == nullptr || pipelineLayout->bindlessGroup == UINT32_MAX)
+            return;
+        if (m_bindlessHeapLayout == m_pipelineLayout && m_bindlessHeapBindPoint == m_pipelineBindPoint)
+            return;
+
+        m_bindlessHeapLayout    = m_pipelineLayout;
+        m_bindlessHeapBindPoint = m_pipelineBindPoint;
+
+        IBindGroup* heap = m_device->m_bindlessHeap.GetBindGroup();
+        if (m_device->GetFeatures().hasDescriptorBuffer)
+        {
+            uint32_t     bufferIndex = 0;
+            VkDeviceSize offset      = heap->descriptorOffset;
+            vkCmdSetDescriptorBufferOffsetsEXT(m_commandBuffer, m_pipelineBindPoint, pipelineLayout->handle, pipelineLayout->bindlessGroup, 1, &bufferIndex, &offset);
+        }
+        else
+        {
+            vkCmdBindDescriptorSets(m_commandBuffer, m_pipelineBindPoint, pipelineLayout->handle, pipelineLayout->bindlessGroup, 1, &heap->descriptorSet, 0, nullptr);
+        }
+    }
+
+    void ICommandList::SetCullMode(PipelineRasterizerStateCullMode cullMode)
+    {
+        ZoneScoped;
+
+        VkCullModeFlags vkCullMode = ConvertCullModeFlags(cullMode);
+        if (UpdateDynamicState(m_dynamicState.cullMode, vkCullMode))
+            vkCmdSetCullMode(m_commandBuffer, vkCullMode);
+    }
+
+    void ICommandList::SetFrontFace(PipelineRasterizerStateFrontFace frontFace)
+    {
+        ZoneScoped;
+
+        VkFrontFace vkFrontFace = ConvertFrontFace(frontFace);
+        if (UpdateDynamicState(m_dynamicState.frontFace, vkFrontFace))
+            vkCmdSetFrontFace(m_commandBuffer, vkFrontFace);
+    }
+
+    void ICommandList::SetDepthState(const PipelineDepthStencilStateDesc& depthStencilState)
+    {
+        ZoneScoped;
+
+        VkBool32    depthTestEnable   = ConvertBool(depthStencilState.depthTestEnable);
+        VkBool32    depthWriteEnable  = ConvertBool(depthStencilState.depthWriteEnable);
+        VkCompareOp depthCompareOp    = ConvertCompareOp(depthStencilState.compareOperator);
+        VkBool32    stencilTestEnable = ConvertBool(depthStencilState.stencilTestEnable);
+        if (UpdateDynamicState(m_dynamicState.depthTestEnable, depthTestEnable))
+            vkCmdSetDepthTestEnable(m_commandBuffer, depthTestEnable);
+        if (UpdateDynamicState(m_dynamicState.depthWriteEnable, depthWriteEnable))
+            vkCmdSetDepthWriteEnable(m_commandBuffer, depthWriteEnable);
+        if (UpdateDynamicState(m_dynamicState.depthCompareOp, depthCompareOp))
+            vkCmdSetDepthCompareOp(m_commandBuffer, depthCompareOp);
+        if (UpdateDynamicState(m_dynamicState.stencilTestEnable, stencilTestEnable))
+            vkCmdSetStencilTestEnable(m_commandBuffer, stencilTestEnable);
+    }
+
+    void ICommandList::SetColorBlendEnable(uint32_t firstAttachment, TL::Span<const bool> enables)
+    {
+        ZoneScoped;
+
+        TL_ASSERT(m_device->GetFeatures().hasDynamicColorBlendEnable || m_areShadersBound);
+        TL_ASSERT(firstAttachment + enables.size() <= GraphicsPipelineDynamicState::MaxColorAttachments);
+
+        // Only the range between the first and last changed attachment is recorded.
+        VkBool32 vkEnables[GraphicsPipelineDynamicState::MaxColorAttachments];
+        uint32_t first = UINT32_MAX, last = 0;
+        for (uint32_t i = 0; i < enables.size(); ++i)
+        {
+            vkEnables[i] = ConvertBool(enables[i]);
+            if (UpdateDynamicState(m_dynamicState.blendEnables[firstAttachment + i], vkEnables[i]))
+            {
+                first = std::min(first, i);
+                last  = i;
+            }
+        }
+
+        if (first != UINT32_MAX)
+            vkCmdSetColorBlendEnableEXT(m_commandBuffer, firstAttachment + first, last - first + 1, vkEnables + first);
+    }
+
     void ICommandList::BindVertexBuffers(uint32_t firstBinding, TL::Span<const BufferBindingInfo> vertexBuffers)
     {
         ZoneScoped;
@@ -1015,10 +1332,10 @@ namespace RHI::Vulkan
     {
         ZoneScoped;
 
-        TL::Vector<VkAccelerationStructureGeometryKHR>              geometries{m_device->m_arena};
-        TL::Vector<VkAccelerationStructureBuildGeometryInfoKHR>     geometryInfos{m_device->m_arena};
-        TL::Vector<VkAccelerationStructureBuildRangeInfoKHR>        rangeInfos{m_device->m_arena};
-        TL::Vector<const VkAccelerationStructureBuildRangeInfoKHR*> pRangeInfos{m_device->m_arena};
+        TL::Vector<VkAccelerationStructureGeometryKHR>              geometries{m_pool->m_scratchArena};
+        TL::Vector<VkAccelerationStructureBuildGeometryInfoKHR>     geometryInfos{m_pool->m_scratchArena};
+        TL::Vector<VkAccelerationStructureBuildRangeInfoKHR>        rangeInfos{m_pool->m_scratchArena};
+        TL::Vector<const VkAccelerationStructureBuildRangeInfoKHR*> pRangeInfos{m_pool->m_scratchArena};
 
         geometries.resize(buildInfos.size());
         geometryInfos.resize(buildInfos.size());
@@ -1078,10 +1395,10 @@ namespace RHI::Vulkan
     {
         ZoneScoped;
 
-        TL::Vector<VkAccelerationStructureGeometryKHR>              geometries{m_device->m_arena};
-        TL::Vector<VkAccelerationStructureBuildRangeInfoKHR>        rangeInfos{m_device->m_arena};
-        TL::Vector<VkAccelerationStructureBuildGeometryInfoKHR>     geometryInfos{m_device->m_arena};
-        TL::Vector<const VkAccelerationStructureBuildRangeInfoKHR*> pRangeInfos{m_device->m_arena};
+        TL::Vector<VkAccelerationStructureGeometryKHR>              geometries{m_pool->m_scratchArena};
+        TL::Vector<VkAccelerationStructureBuildRangeInfoKHR>        rangeInfos{m_pool->m_scratchArena};
+        TL::Vector<VkAccelerationStructureBuildGeometryInfoKHR>     geometryInfos{m_pool->m_scratchArena};
+        TL::Vector<const VkAccelerationStructureBuildRangeInfoKHR*> pRangeInfos{m_pool->m_scratchArena};
 
         uint32_t totalGeometries = 0;
         for (const auto& info : buildInfos)
@@ -1148,7 +1465,7 @@ namespace RHI::Vulkan
     void ICommandList::WriteAccelerationStructuresSizes(TL::Span<const AccelerationStructure*> accelerationStructures, QueryPool* _queryPool, uint32_t queryPoolOffset)
     {
         IQueryPool*                            queryPool = (IQueryPool*)_queryPool;
-        TL::Vector<VkAccelerationStructureKHR> asHandles{m_device->m_arena};
+        TL::Vector<VkAccelerationStructureKHR> asHandles{m_pool->m_scratchArena};
         asHandles.reserve(accelerationStructures.size());
         for (const auto* as : accelerationStructures)
         {
@@ -1161,7 +1478,7 @@ namespace RHI::Vulkan
     void ICommandList::WriteMicromapsSizes(TL::Span<const Micromap*> micromaps, QueryPool* _queryPool, uint32_t queryPoolOffset)
     {
         IQueryPool*               queryPool = (IQueryPool*)_queryPool;
-        TL::Vector<VkMicromapEXT> micromapHandles{m_device->m_arena};
+        TL::Vector<VkMicromapEXT> micromapHandles{m_pool->m_scratchArena};
         micromapHandles.reserve(micromaps.size());
         for (const auto* micromap : micromaps)
         {
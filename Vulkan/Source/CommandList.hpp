@@ -22,14 +22,20 @@ namespace RHI::Vulkan
         ResultCode Init(IDevice* device, const CommandPoolCreateInfo& createInfo);
         void       Shutdown(IDevice* device);
 
-        void         Reset() override;
-        CommandList* Allocate() override;
+        void             Reset() override;
+        CommandList*     Allocate() override;
+        CommandPoolStats GetStats() const override;
 
         TL::String                m_name;
-        TL::Arena                 m_arena;
+        // Scratch memory for command recording, owned by the pool so lists from different pools can be recorded concurrently.
+        TL::Arena                 m_scratchArena;
         IDevice*                  m_device;
         VkCommandPool             m_commandPool;
-        TL::Vector<ICommandList*> m_commandList;
+        QueueType                 m_queueType;
+        // Every command list ever allocated from this pool, [m_availableIndex, size) are free for reuse.
+        TL::Vector<ICommandList*> m_commandLists;
+        uint32_t                  m_availableIndex = 0;
+        CommandPoolStats          m_stats          = {};
     };
 
     class ICommandList final : public RHI::CommandList
@@ -49,6 +55,7 @@ namespace RHI::Vulkan
         void PopDebugMarker() override;
         void InsertDebugMarker(const char* name, uint32_t bgra) override;
         void AddPipelineBarrier(TL::Span<const BarrierInfo> barriers, TL::Span<const ImageBarrierInfo> imageBarriers, TL::Span<const BufferBarrierInfo> bufferBarriers) override;
+        void AddAliasingBarriers(TransientHeap* heap, uint32_t usePoint) override;
         void BeginRenderPass(const RenderPassBeginInfo& beginInfo) override;
         void EndRenderPass() override;
         void BeginComputePass(const ComputePassBeginInfo& beginInfo) override;
@@ -63,8 +70,13 @@ namespace RHI::Vulkan
         void BindGraphicsPipeline(const GraphicsPipeline* pipelineState) override;
         void BindComputePipeline(const ComputePipeline* pipelineState) override;
         void BindRayTracingPipeline(const RayTracingPipeline* pipelineState) override;
+        void BindShaders(const ShaderObject* shaderObject) override;
         void SetViewport(float offsetX, float offsetY, float width, float height, float minDepth, float maxDepth) override;
         void SetScissor(int32_t offsetX, int32_t offsetY, uint32_t width, uint32_t height) override;
+        void SetCullMode(PipelineRasterizerStateCullMode cullMode) override;
+        void SetFrontFace(PipelineRasterizerStateFrontFace frontFace) override;
+        void SetDepthState(const PipelineDepthStencilStateDesc& depthStencilState) override;
+        void SetColorBlendEnable(uint32_t firstAttachment, TL::Span<const bool> enables) override;
         void BindVertexBuffers(uint32_t firstBinding, TL::Span<const BufferBindingInfo> vertexBuffers) override;
         void BindIndexBuffer(const BufferBindingInfo& indexBuffer, IndexType indexType) override;
         void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) override;
@@ -89,16 +101,41 @@ namespace RHI::Vulkan
         void WriteAccelerationStructuresSizes(TL::Span<const AccelerationStructure*> accelerationStructures, QueryPool* queryPool, uint32_t queryPoolOffset) override;
         void WriteMicromapsSizes(TL::Span<const Micromap*> micromaps, QueryPool* queryPool, uint32_t queryPoolOffset) override;
 
+    private:
+        // Forgets the dynamic state values, the next Set* call records unconditionally.
+        void ResetDynamicState();
+        // Binds the bindless heap when the current layout uses it and it is not bound for that layout yet.
+        void BindBindlessHeap();
+
     public:
+        // Last recorded extended dynamic state, UnknownDynamicState until recorded.
+        static constexpr uint32_t UnknownDynamicState = UINT32_MAX;
+        struct DynamicStateCache
+        {
+            uint32_t cullMode;
+            uint32_t frontFace;
+            uint32_t depthTestEnable;
+            uint32_t depthWriteEnable;
+            uint32_t depthCompareOp;
+            uint32_t stencilTestEnable;
+            uint32_t blendEnables[8];
+        };
+
         IDevice*            m_device            = nullptr;
+        ICommandPool*       m_pool              = nullptr;
         VkCommandBuffer     m_commandBuffer     = VK_NULL_HANDLE;
         PipelineLayout*     m_pipelineLayout    = nullptr;
         VkPipelineBindPoint m_pipelineBindPoint = VK_PIPELINE_BIND_POINT_MAX_ENUM;
+        // Layout and bind point the bindless heap was last bound with.
+        PipelineLayout*     m_bindlessHeapLayout    = nullptr;
+        VkPipelineBindPoint m_bindlessHeapBindPoint = VK_PIPELINE_BIND_POINT_MAX_ENUM;
         bool                m_hasVertexBuffer         : 1;
         bool                m_hasIndexBuffer          : 1;
         bool                m_isGraphicsPipelineBound : 1;
         bool                m_isComputePipelineBound  : 1;
         bool                m_hasViewportSet          : 1;
         bool                m_hasScissorSet           : 1;
+        bool                m_areShadersBound         : 1;
+        DynamicStateCache   m_dynamicState;
     };
 } // namespace RHI::Vulkan
\ No newline at end of file
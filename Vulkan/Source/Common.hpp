@@ -181,6 +181,12 @@ namespace RHI::Vulkan
         return x;              \
     }
 
+    // alignment must be a power of two.
+    inline static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
     inline static VkFormat ConvertFormat(Format format)
     {
         TL_ASSERT(format < Format::COUNT);
@@ -270,6 +276,70 @@ namespace RHI::Vulkan
         return VK_INDEX_TYPE_MAX_ENUM;
     }
 
+    inline static VkCompareOp ConvertCompareOp(CompareOperator compareOperator)
+    {
+        switch (compareOperator)
+        {
+        case CompareOperator::Undefined:      return VK_COMPARE_OP_NEVER;
+        case CompareOperator::Never:          return VK_COMPARE_OP_NEVER;
+        case CompareOperator::Equal:          return VK_COMPARE_OP_EQUAL;
+        case CompareOperator::NotEqual:       return VK_COMPARE_OP_NOT_EQUAL;
+        case CompareOperator::Greater:        return VK_COMPARE_OP_GREATER;
+        case CompareOperator::GreaterOrEqual: return VK_COMPARE_OP_GREATER_OR_EQUAL;
+        case CompareOperator::Less:           return VK_COMPARE_OP_LESS;
+        case CompareOperator::LessOrEqual:    return VK_COMPARE_OP_LESS_OR_EQUAL;
+        case CompareOperator::Always:         return VK_COMPARE_OP_ALWAYS;
+        }
+        TL_UNREACHABLE();
+        return VK_COMPARE_OP_MAX_ENUM;
+    }
+
+    inline static VkBool32 ConvertBool(bool value)
+    {
+        return value ? VK_TRUE : VK_FALSE;
+    }
+
+    // Shared by pipelines and shader objects, an enabled stencil test passes and keeps the stencil value.
+    inline static VkStencilOpState ConvertStencilOpState(const PipelineDepthStencilStateDesc& depthStencilState)
+    {
+        if (!depthStencilState.stencilTestEnable)
+            return {};
+
+        return {
+            .failOp      = VK_STENCIL_OP_KEEP,
+            .passOp      = VK_STENCIL_OP_KEEP,
+            .depthFailOp = VK_STENCIL_OP_KEEP,
+            .compareOp   = VK_COMPARE_OP_ALWAYS,
+            .compareMask = 0xff,
+            .writeMask   = 0xff,
+            .reference   = 0,
+        };
+    }
+
+    inline static VkCullModeFlags ConvertCullModeFlags(PipelineRasterizerStateCullMode cullMode)
+    {
+        switch (cullMode)
+        {
+        case PipelineRasterizerStateCullMode::None:      return VK_CULL_MODE_NONE;
+        case PipelineRasterizerStateCullMode::FrontFace: return VK_CULL_MODE_FRONT_BIT;
+        case PipelineRasterizerStateCullMode::BackFace:  return VK_CULL_MODE_BACK_BIT;
+        case PipelineRasterizerStateCullMode::Discard:   return VK_CULL_MODE_FLAG_BITS_MAX_ENUM;
+        }
+        TL_UNREACHABLE();
+        return VK_CULL_MODE_FLAG_BITS_MAX_ENUM;
+    }
+
+    inline static VkFrontFace ConvertFrontFace(PipelineRasterizerStateFrontFace frontFace)
+    {
+        switch (frontFace)
+        {
+        case PipelineRasterizerStateFrontFace::Clockwise:        return VK_FRONT_FACE_CLOCKWISE;
+        case PipelineRasterizerStateFrontFace::CounterClockwise: return VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        }
+        TL_UNREACHABLE();
+        return VK_FRONT_FACE_MAX_ENUM;
+    }
+
     inline static VkAccelerationStructureGeometryKHR
     convertGeometryData(const AccelerationStructureGeometry& trianglesData)
     {
@@ -357,6 +427,7 @@ namespace RHI::Vulkan
         else if constexpr (std::is_same_v<T, VkAccelerationStructureNV>) return VK_OBJECT_TYPE_ACCELERATION_STRUCTURE_NV;
         else if constexpr (std::is_same_v<T, VkDescriptorUpdateTemplateKHR>) return VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_KHR;
         else if constexpr (std::is_same_v<T, VkSamplerYcbcrConversionKHR>) return VK_OBJECT_TYPE_SAMPLER_YCBCR_CONVERSION_KHR;
+        else if constexpr (std::is_same_v<T, VkShaderEXT>) return VK_OBJECT_TYPE_SHADER_EXT;
         else
         {
             return VK_OBJECT_TYPE_UNKNOWN;
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <format>
+#include <thread>
 
 #include <tracy/Tracy.hpp>
 
@@ -82,6 +83,7 @@ namespace RHI::Vulkan
         case VK_OBJECT_TYPE_CU_FUNCTION_NVX:            return "VkCuFunctionNVX";
         case VK_OBJECT_TYPE_ACCELERATION_STRUCTURE_KHR: return "VkAccelerationStructureKHR";
         case VK_OBJECT_TYPE_ACCELERATION_STRUCTURE_NV:  return "VkAccelerationStructureNV";
+        case VK_OBJECT_TYPE_SHADER_EXT:                 return "VkShaderEXT";
         default:                                        return "UNKNOWN";
         };
     }
@@ -152,12 +154,28 @@ namespace RHI::Vulkan
         if (debugName)
             m_device->SetDebugName(m_queue, debugName);
 
+        m_lastSubmitValue = 0;
+
+        ResultCode result = m_timeline.Init(device, {.name = nullptr, .initialValue = 0});
+        if (IsError(result))
+            return VK_ERROR_INITIALIZATION_FAILED;
+
+        if (debugName)
+            m_device->SetDebugName(m_timeline.semaphore, "{} - timeline", debugName);
+
         return VK_SUCCESS;
     }
 
     void IQueue::Shutdown()
     {
+        if (m_queue == VK_NULL_HANDLE)
+            return;
+
         vkQueueWaitIdle(m_queue);
+
+        // The delete queue is already flushed at this point, destroy directly.
+        vkDestroySemaphore(m_device->m_device, m_timeline.semaphore, nullptr);
+        m_timeline.semaphore = VK_NULL_HANDLE;
     }
 
     void IQueue::BeginAnnotation(const char* name, uint32_t bgra)
@@ -170,6 +188,7 @@ namespace RHI::Vulkan
                 .pLabelName = name,
                 .color      = {},
             };
+            std::lock_guard lock(*m_mutex);
             vkQueueBeginDebugUtilsLabelEXT(m_queue, &label);
         }
     }
@@ -178,6 +197,7 @@ namespace RHI::Vulkan
     {
         if (vkQueueEndDebugUtilsLabelEXT)
         {
+            std::lock_guard lock(*m_mutex);
             vkQueueEndDebugUtilsLabelEXT(m_queue);
         }
     }
@@ -192,86 +212,162 @@ namespace RHI::Vulkan
                 .pLabelName = name,
                 .color      = {},
             };
+            std::lock_guard lock(*m_mutex);
             vkQueueInsertDebugUtilsLabelEXT(m_queue, &label);
         }
     }
 
-    void IQueue::Submit(const QueueSubmitInfo& submitInfo)
+    uint64_t IQueue::Submit(const QueueSubmitInfo& submitInfo)
     {
-        TL::Vector<VkSemaphoreSubmitInfo>     waitSemaphores{m_device->m_arena};
-        TL::Vector<VkCommandBufferSubmitInfo> commandBufferSubmitInfos{m_device->m_arena};
-        TL::Vector<VkSemaphoreSubmitInfo>     signalSemaphores{m_device->m_arena};
+        ZoneScoped;
 
-        for (auto _fence : submitInfo.waitFences)
-        {
-            auto fence = (IFence*)_fence.fence;
-            waitSemaphores.push_back({
-                .sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-                .semaphore = fence->semaphore,
-                .value     = _fence.value,
-                .stageMask = ConvertPipelineStageFlags(_fence.stage)
-                // .deviceMask    = 1,
-            });
-        }
+        uint64_t submitValue = SubmitBatch({&submitInfo, 1});
+        if (submitInfo.presentSwapchains.empty() == false)
+            Present(submitInfo.presentSwapchains);
+        return submitValue;
+    }
 
-        for (auto _fence : submitInfo.signalFences)
+    uint64_t IQueue::SubmitBatch(TL::Span<const QueueSubmitInfo> submitInfos)
+    {
+        ZoneScoped;
+
+        // Offsets into the flattened semaphore and command buffer arrays, resolved once they stop growing.
+        struct SubmitRange
         {
-            auto fence = (IFence*)_fence.fence;
-            signalSemaphores.push_back({
-                .sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-                .semaphore = fence->semaphore,
-                .value     = _fence.value,
-                .stageMask = ConvertPipelineStageFlags(_fence.stage),
-            });
-        }
+            uint32_t waitOffset, waitCount;
+            uint32_t commandBufferOffset, commandBufferCount;
+            uint32_t signalOffset, signalCount;
+        };
 
-        for (auto cmd : submitInfo.commandLists)
+        // Held until the submission, so timeline values reach the VkQueue in increasing order. Also guards m_arena.
+        std::lock_guard lock(*m_mutex);
+        m_arena.reset();
+
+        TL::Vector<VkSemaphoreSubmitInfo>     waitSemaphores{m_arena};
+        TL::Vector<VkCommandBufferSubmitInfo> commandBufferSubmitInfos{m_arena};
+        TL::Vector<VkSemaphoreSubmitInfo>     signalSemaphores{m_arena};
+        TL::Vector<SubmitRange>               submitRanges{m_arena};
+
+        uint64_t submitValue = ++m_lastSubmitValue;
+
+        // An empty batch still advances the timeline, so callers can always wait on the returned value.
+        size_t submitCount = std::max<size_t>(submitInfos.size(), 1);
+        for (size_t submitIndex = 0; submitIndex < submitCount; ++submitIndex)
         {
-            auto commandList = (ICommandList*)cmd;
-            commandBufferSubmitInfos.push_back({
-                .sType         = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
-                .commandBuffer = commandList->m_commandBuffer,
-                // .deviceMask    = 1,
-            });
+            SubmitRange range{
+                .waitOffset          = (uint32_t)waitSemaphores.size(),
+                .commandBufferOffset = (uint32_t)commandBufferSubmitInfos.size(),
+                .signalOffset        = (uint32_t)signalSemaphores.size(),
+            };
+
+            if (submitIndex < submitInfos.size())
+            {
+                const QueueSubmitInfo& submitInfo = submitInfos[submitIndex];
+
+                for (auto _fence : submitInfo.waitFences)
+                {
+                    auto fence = (IFence*)_fence.fence;
+                    waitSemaphores.push_back({
+                        .sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                        .semaphore = fence->semaphore,
+                        .value     = _fence.value,
+                        .stageMask = ConvertPipelineStageFlags(_fence.stage)
+                        // .deviceMask    = 1,
+                    });
+                }
+
+                for (auto _fence : submitInfo.signalFences)
+                {
+                    auto fence = (IFence*)_fence.fence;
+                    signalSemaphores.push_back({
+                        .sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                        .semaphore = fence->semaphore,
+                        .value     = _fence.value,
+                        .stageMask = ConvertPipelineStageFlags(_fence.stage),
+                    });
+                }
+
+                for (auto cmd : submitInfo.commandLists)
+                {
+                    auto commandList = (ICommandList*)cmd;
+                    commandBufferSubmitInfos.push_back({
+                        .sType         = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+                        .commandBuffer = commandList->m_commandBuffer,
+                        // .deviceMask    = 1,
+                    });
+                }
+
+                // Signal the binary semaphore the next Present() on these swapchains waits on.
+                for (auto _swapchain : submitInfo.presentSwapchains)
+                {
+                    ISwapchain* swapchain = (ISwapchain*)_swapchain;
+
+                    VkSemaphore presentSemaphore = swapchain->m_presentSemaphore[swapchain->m_presentSemaphoreIndex];
+                    signalSemaphores.push_back({
+                        .sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                        .semaphore = presentSemaphore,
+                    });
+                }
+            }
+
+            // Signal operations cover every command submitted earlier to this queue, so the
+            // timeline only needs to be signaled by the last submit of the batch.
+            if (submitIndex == submitCount - 1)
+            {
+                signalSemaphores.push_back({
+                    .sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                    .semaphore = m_timeline.semaphore,
+                    .value     = submitValue,
+                    .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                });
+            }
+
+            range.waitCount          = (uint32_t)waitSemaphores.size() - range.waitOffset;
+            range.commandBufferCount = (uint32_t)commandBufferSubmitInfos.size() - range.commandBufferOffset;
+            range.signalCount        = (uint32_t)signalSemaphores.size() - range.signalOffset;
+            submitRanges.push_back(range);
         }
 
-        for (auto _swapchain : submitInfo.presentSwapchains)
+        TL::Vector<VkSubmitInfo2> vkSubmitInfos{m_arena};
+        vkSubmitInfos.reserve(submitRanges.size());
+        for (const auto& range : submitRanges)
         {
-            ISwapchain* swapchain = (ISwapchain*)_swapchain;
-
-            VkSemaphore presentSemaphore = swapchain->m_presentSemaphore[swapchain->m_presentSemaphoreIndex];
-            signalSemaphores.push_back({
-                .sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-                .semaphore = presentSemaphore,
+            vkSubmitInfos.push_back({
+                .sType                    = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+                .pNext                    = nullptr,
+                .flags                    = {},
+                .waitSemaphoreInfoCount   = range.waitCount,
+                .pWaitSemaphoreInfos      = waitSemaphores.data() + range.waitOffset,
+                .commandBufferInfoCount   = range.commandBufferCount,
+                .pCommandBufferInfos      = commandBufferSubmitInfos.data() + range.commandBufferOffset,
+                .signalSemaphoreInfoCount = range.signalCount,
+                .pSignalSemaphoreInfos    = signalSemaphores.data() + range.signalOffset,
             });
         }
 
-        // m_lastSubmitValue++;
-
-        VkSubmitInfo2 vksubmitInfo = {
-            .sType                    = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
-            .pNext                    = nullptr,
-            .flags                    = {},
-            .waitSemaphoreInfoCount   = (uint32_t)waitSemaphores.size(),
-            .pWaitSemaphoreInfos      = waitSemaphores.data(),
-            .commandBufferInfoCount   = (uint32_t)commandBufferSubmitInfos.size(),
-            .pCommandBufferInfos      = commandBufferSubmitInfos.data(),
-            .signalSemaphoreInfoCount = (uint32_t)signalSemaphores.size(),
-            .pSignalSemaphoreInfos    = signalSemaphores.data(),
-        };
-        VulkanResult result = vkQueueSubmit2(m_queue, 1, &vksubmitInfo, VK_NULL_HANDLE);
+        VulkanResult result = vkQueueSubmit2(m_queue, (uint32_t)vkSubmitInfos.size(), vkSubmitInfos.data(), VK_NULL_HANDLE);
         TL_ASSERT(result.IsSuccess());
 
-        vkQueueWaitIdle(m_queue);
+        return submitValue;
+    }
+
+    void IQueue::Present(TL::Span<Swapchain* const> _swapchains)
+    {
+        ZoneScoped;
+
+        if (_swapchains.empty())
+            return;
 
-        // assert queue is graphics
-        if (submitInfo.presentSwapchains.empty() == false)
         {
-            TL::Vector<VkSwapchainKHR> swapchains{m_device->m_arena};
-            TL::Vector<uint32_t>       imageIndices{m_device->m_arena};
-            TL::Vector<VkSemaphore>    presentWaitSemaphores{m_device->m_arena};
+            std::lock_guard lock(*m_mutex);
+            m_arena.reset();
+
+            // assert queue is graphics
+            TL::Vector<VkSwapchainKHR> swapchains{m_arena};
+            TL::Vector<uint32_t>       imageIndices{m_arena};
+            TL::Vector<VkSemaphore>    presentWaitSemaphores{m_arena};
 
-            for (auto _swapchain : submitInfo.presentSwapchains)
+            for (auto _swapchain : _swapchains)
             {
                 ISwapchain* swapchain = (ISwapchain*)_swapchain;
                 VkSemaphore semaphore = swapchain->m_presentSemaphore[swapchain->m_presentSemaphoreIndex];
@@ -295,17 +391,28 @@ namespace RHI::Vulkan
             vkQueuePresentKHR(m_queue, &presentInfos);
         }
 
-        vkQueueWaitIdle(m_queue);
-
-        for (auto _swapchain : submitInfo.presentSwapchains)
+        for (auto _swapchain : _swapchains)
         {
             ISwapchain* swapchain = (ISwapchain*)_swapchain;
             swapchain->AcquireNextImage(m_device);
         }
     }
 
+    Fence* IQueue::GetTimelineFence()
+    {
+        return &m_timeline;
+    }
+
+    uint64_t IQueue::GetCompletedValue() const
+    {
+        uint64_t value = 0;
+        vkGetSemaphoreCounterValue(m_device->m_device, m_timeline.semaphore, &value);
+        return value;
+    }
+
     void IQueue::WaitIdle()
     {
+        std::lock_guard lock(*m_mutex);
         vkQueueWaitIdle(m_queue);
     }
 
@@ -440,6 +547,13 @@ namespace RHI::Vulkan
         bool enableRayTracing              = true;
         bool enableDescriptorIndexing      = true;
         bool enableDeviceGeneratedCommands = true;
+        // Optional, enabled when the selected physical device supports them.
+        bool enableGraphicsPipelineLibrary = false;
+        bool enableDynamicColorBlendEnable = false;
+        bool enableShaderObject            = false;
+        bool enableShaderModuleIdentifier  = false;
+        // Opt-in, bind groups live in a descriptor buffer instead of a descriptor pool.
+        bool enableDescriptorBuffer        = false;
 
         if (enablePushDescriptors)
         {
@@ -510,11 +624,76 @@ namespace RHI::Vulkan
 
                 if (containAllLayers && containAllExtensions)
                 {
-                    m_physicalDevice = physicalDevice;
+                    m_physicalDevice              = physicalDevice;
+                    enableGraphicsPipelineLibrary = availableDeviceExtensions.contains(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+                                                    availableDeviceExtensions.contains(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+
+                    // Only chain the feature structs of extensions the device exposes.
+                    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT  extendedDynamicState3Features{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT};
+                    VkPhysicalDeviceShaderObjectFeaturesEXT           shaderObjectFeatures{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT};
+                    VkPhysicalDeviceShaderModuleIdentifierFeaturesEXT shaderModuleIdentifierFeatures{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MODULE_IDENTIFIER_FEATURES_EXT};
+                    VkPhysicalDeviceDescriptorBufferFeaturesEXT       descriptorBufferFeatures{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT};
+                    VkPhysicalDeviceFeatures2                         supportedFeatures{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+                    if (availableDeviceExtensions.contains(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME))
+                    {
+                        extendedDynamicState3Features.pNext = supportedFeatures.pNext;
+                        supportedFeatures.pNext             = &extendedDynamicState3Features;
+                    }
+                    if (availableDeviceExtensions.contains(VK_EXT_SHADER_OBJECT_EXTENSION_NAME))
+                    {
+                        shaderObjectFeatures.pNext = supportedFeatures.pNext;
+                        supportedFeatures.pNext    = &shaderObjectFeatures;
+                    }
+                    if (availableDeviceExtensions.contains(VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME))
+                    {
+                        shaderModuleIdentifierFeatures.pNext = supportedFeatures.pNext;
+                        supportedFeatures.pNext              = &shaderModuleIdentifierFeatures;
+                    }
+                    if (appInfo.useDescriptorBuffer && availableDeviceExtensions.contains(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME))
+                    {
+                        descriptorBufferFeatures.pNext = supportedFeatures.pNext;
+                        supportedFeatures.pNext        = &descriptorBufferFeatures;
+                    }
+                    vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures);
+                    enableDynamicColorBlendEnable = extendedDynamicState3Features.extendedDynamicState3ColorBlendEnable;
+                    enableShaderObject            = shaderObjectFeatures.shaderObject;
+                    enableShaderModuleIdentifier  = shaderModuleIdentifierFeatures.shaderModuleIdentifier;
+                    // Push bind groups are always enabled, so they must keep working next to the descriptor buffer.
+                    enableDescriptorBuffer        = descriptorBufferFeatures.descriptorBuffer && descriptorBufferFeatures.descriptorBufferPushDescriptors;
                     break;
                 }
             }
 
+            if (enableGraphicsPipelineLibrary)
+            {
+                requiredDeviceExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+                requiredDeviceExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+            }
+
+            if (enableDynamicColorBlendEnable)
+            {
+                requiredDeviceExtensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+            }
+
+            if (enableShaderObject)
+            {
+                requiredDeviceExtensions.push_back(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+            }
+
+            if (enableShaderModuleIdentifier)
+            {
+                requiredDeviceExtensions.push_back(VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME);
+            }
+
+            if (enableDescriptorBuffer)
+            {
+                requiredDeviceExtensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+            }
+            else if (appInfo.useDescriptorBuffer)
+            {
+                TL::LogWarn("RHI Vulkan: Descriptor buffers are not supported, bind groups use descriptor pools.");
+            }
+
             if (m_physicalDevice == VK_NULL_HANDLE)
             {
                 TL::LogError("RHI Vulkan: No suitable physical device found.");
@@ -638,13 +817,45 @@ namespace RHI::Vulkan
         };
 
         if (enableRayTracing) pNext = &rayTracingPositionFetchFeaturesKHR;
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{
+            .sType                   = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+            .pNext                   = pNext,
+            .graphicsPipelineLibrary = VK_TRUE,
+        };
+        if (enableGraphicsPipelineLibrary) pNext = &graphicsPipelineLibraryFeatures;
+        // The extended dynamic state 1 and 2 commands are core in Vulkan 1.3, only the blend enables need version 3.
+        VkPhysicalDeviceExtendedDynamicState3FeaturesEXT extendedDynamicState3Features{
+            .sType                                 = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT,
+            .pNext                                 = pNext,
+            .extendedDynamicState3ColorBlendEnable = VK_TRUE,
+        };
+        if (enableDynamicColorBlendEnable) pNext = &extendedDynamicState3Features;
+        VkPhysicalDeviceShaderObjectFeaturesEXT shaderObjectFeatures{
+            .sType        = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT,
+            .pNext        = pNext,
+            .shaderObject = VK_TRUE,
+        };
+        if (enableShaderObject) pNext = &shaderObjectFeatures;
+        VkPhysicalDeviceShaderModuleIdentifierFeaturesEXT shaderModuleIdentifierFeatures{
+            .sType                  = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MODULE_IDENTIFIER_FEATURES_EXT,
+            .pNext                  = pNext,
+            .shaderModuleIdentifier = VK_TRUE,
+        };
+        if (enableShaderModuleIdentifier) pNext = &shaderModuleIdentifierFeatures;
+        VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeatures{
+            .sType                           = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+            .pNext                           = pNext,
+            .descriptorBuffer                = VK_TRUE,
+            .descriptorBufferPushDescriptors = VK_TRUE,
+        };
+        if (enableDescriptorBuffer) pNext = &descriptorBufferFeatures;
         VkPhysicalDeviceVulkan13Features features13{
             .sType                                              = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
             .pNext                                              = pNext,
             .robustImageAccess                                  = VK_FALSE,
             .inlineUniformBlock                                 = VK_FALSE,
             .descriptorBindingInlineUniformBlockUpdateAfterBind = VK_FALSE,
-            .pipelineCreationCacheControl                       = VK_FALSE,
+            .pipelineCreationCacheControl                       = enableShaderModuleIdentifier ? VK_TRUE : VK_FALSE, // Needed to create pipelines from module identifiers.
             .privateData                                        = VK_FALSE,
             .shaderDemoteToHelperInvocation                     = VK_FALSE,
             .shaderTerminateInvocation                          = VK_FALSE,
@@ -860,7 +1071,9 @@ namespace RHI::Vulkan
         result = vmaCreateAllocator(&vmaCI, &m_deviceAllocator);
         VkResultTry(result);
 
-        VkPhysicalDeviceRayTracingPipelinePropertiesKHR    rayTracingPipelineProperties    = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_PROPERTIES_KHR, .pNext = nullptr};
+        m_descriptorBufferProperties = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT, .pNext = nullptr};
+
+        VkPhysicalDeviceRayTracingPipelinePropertiesKHR    rayTracingPipelineProperties    = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_PROPERTIES_KHR, .pNext = enableDescriptorBuffer ? &m_descriptorBufferProperties : nullptr};
         VkPhysicalDeviceAccelerationStructurePropertiesKHR accelerationStructureProperties = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR, .pNext = &rayTracingPipelineProperties};
         VkPhysicalDeviceMeshShaderPropertiesEXT            meshShadersFeatures             = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_PROPERTIES_EXT, .pNext = &accelerationStructureProperties};
         VkPhysicalDevicePushDescriptorProperties           pushDescriptorProperties        = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR, .pNext = &meshShadersFeatures};
@@ -881,23 +1094,76 @@ namespace RHI::Vulkan
         m_limits.rayTracingShaderGroupHandleSize                = rayTracingPipelineProperties.shaderGroupHandleSize;
         m_limits.rayTracingShaderGroupHandleAlignment           = rayTracingPipelineProperties.shaderGroupHandleAlignment;
         m_limits.rayTracingShaderGroupBaseAlignment             = rayTracingPipelineProperties.shaderGroupBaseAlignment;
+
+        // Fill DeviceFeatures
+        m_features.hasRaytracing              = enableRayTracing;
+        m_features.hasMeshShaders             = enableMeshShaders;
+        m_features.hasPushBindGroups          = enablePushDescriptors;
+        m_features.hasGraphicsPipelineLibrary = enableGraphicsPipelineLibrary;
+        m_features.hasDynamicColorBlendEnable = enableDynamicColorBlendEnable;
+        m_features.hasShaderObject            = enableShaderObject;
+        m_features.hasShaderModuleIdentifier  = enableShaderModuleIdentifier;
+        m_features.hasDescriptorBuffer        = enableDescriptorBuffer;
+
         result                                                  = m_queue[(uint32_t)QueueType::Graphics].Init(this, "Graphics", graphicsQueueFamilyIndex, 0);
         VkResultTry(result);
 
-        if (computeQueueFamilyIndex)
-        {
-            result = m_queue[(uint32_t)QueueType::Compute].Init(this, "Compute", computeQueueFamilyIndex, 0);
-            VkResultTry(result);
-        }
+        // Without a dedicated family the async queues alias the graphics queue, work still runs
+        // correctly but does not overlap, and ownership transfers between them become no-ops.
+        if (computeQueueFamilyIndex == UINT32_MAX)
+            computeQueueFamilyIndex = graphicsQueueFamilyIndex;
+        result = m_queue[(uint32_t)QueueType::Compute].Init(this, "Compute", computeQueueFamilyIndex, 0);
+        VkResultTry(result);
+
+        if (transferQueueFamilyIndex == UINT32_MAX)
+            transferQueueFamilyIndex = graphicsQueueFamilyIndex;
+        result = m_queue[(uint32_t)QueueType::Transfer].Init(this, "Transfer", transferQueueFamilyIndex, 0);
+        VkResultTry(result);
 
-        if (transferQueueFamilyIndex)
+        // Aliased queues share the first queue's lock, their submissions go to the same VkQueue.
+        for (uint32_t i = 1; i < (uint32_t)QueueType::Count; ++i)
         {
-            result = m_queue[(uint32_t)QueueType::Transfer].Init(this, "Transfer", transferQueueFamilyIndex, 0);
-            VkResultTry(result);
+            for (uint32_t j = 0; j < i; ++j)
+            {
+                if (m_queue[i].m_queue == m_queue[j].m_queue)
+                {
+                    m_queue[i].m_mutex = m_queue[j].m_mutex;
+                    break;
+                }
+            }
         }
 
         result = m_bindGroupAllocator.Init(this);
         VkResultTry(result);
+
+        if (auto heapResult = m_bindlessHeap.Init(this); IsError(heapResult))
+            return heapResult;
+
+        m_bindGroupCache.Init(this, appInfo.bindGroupCacheFrames);
+
+        if (auto cacheResult = m_pipelineCache.Init(this, appInfo.pipelineCachePath); IsError(cacheResult))
+            return cacheResult;
+
+        if (auto compilerResult = m_pipelineCompiler.Init(this, appInfo.pipelineWorkerCount); IsError(compilerResult))
+            return compilerResult;
+
+        m_pipelineManifest.Init(appInfo.pipelineManifestPath);
+
+        m_framesInFlight = std::clamp(appInfo.framesInFlight, 1u, MaxFramesInFlight);
+        for (uint32_t i = 0; i < m_framesInFlight; ++i)
+        {
+            if (auto frameResult = m_frames[i].Init(this, i); IsError(frameResult))
+                return frameResult;
+        }
+
+        m_uploadEngine = TL::CreatePtr<UploadEngine>();
+        if (auto uploadResult = m_uploadEngine->Init(this); IsError(uploadResult))
+            return uploadResult;
+
+        constexpr auto DynamicUsageFlags = BufferUsage::Uniform | BufferUsage::Storage | BufferUsage::VertexIndex | BufferUsage::CopySrc;
+        if (auto ringResult = m_dynamicRing.Init(this, "Dynamic ring", appInfo.dynamicMemorySize, DynamicUsageFlags); IsError(ringResult))
+            return ringResult;
+
         return result;
     }
 
@@ -905,8 +1171,36 @@ namespace RHI::Vulkan
     {
         ZoneScoped;
 
+        // Submit outstanding uploads so their callbacks still run.
+        if (m_uploadEngine)
+            m_uploadEngine->Flush();
+
+        // Finish queued pipelines, their callbacks may still reference the device.
+        m_pipelineCompiler.Shutdown();
+
+        // Submissions no longer block, so drain in-flight work before releasing anything.
+        if (m_device != VK_NULL_HANDLE)
+            WaitIdle();
+
+        ReleasePrecompiledPipelines();
+
+        if (m_uploadEngine)
+        {
+            m_uploadEngine->Poll();
+            m_uploadEngine->Shutdown(this);
+        }
+        m_dynamicRing.Shutdown(this);
+
+        for (uint32_t i = 0; i < m_framesInFlight; ++i)
+            m_frames[i].Shutdown(this);
+
+        // Bind groups released here still go through the delete queue.
+        m_bindGroupCache.Shutdown();
+        m_bindlessHeap.Shutdown(this);
         m_destroyQueue->shutdown(this);
         m_bindGroupAllocator.Shutdown();
+        m_pipelineCache.Shutdown(this);
+        m_pipelineManifest.Shutdown();
 
         m_queue[(int)QueueType::Transfer].Shutdown();
         m_queue[(int)QueueType::Compute].Shutdown();
@@ -921,6 +1215,11 @@ namespace RHI::Vulkan
         vkDestroyInstance(m_instance, nullptr);
     }
 
+    void IDevice::WaitIdle()
+    {
+        vkDeviceWaitIdle(m_device);
+    }
+
     void IDevice::SetDebugName(VkObjectType type, uint64_t handle, const char* name) const
     {
         if (handle == 0 /* VK_NULL_HANDLE */) return;
@@ -958,14 +1257,187 @@ namespace RHI::Vulkan
         TL::destruct(resource);
     }
 
+    template<typename Pipeline>
+    inline void waitPipelineReady(const Pipeline* pipeline)
+    {
+        // Whoever inserted the pipeline is already running its Init, or queued it ahead of any task waiting here.
+        while (!pipeline->ready.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+
+    // Waits for a pipeline another caller inserted, drops the reference and returns null if its initialization failed.
+    template<typename Pipeline>
+    inline Pipeline* waitPipelineResult(IDevice* device, Pipeline* pipeline)
+    {
+        waitPipelineReady(pipeline);
+        if (pipeline->handle != VK_NULL_HANDLE)
+            return pipeline;
+        if (device->m_pipelineStateCache.Release(pipeline, pipeline->cacheKey))
+            destroyImpl<Pipeline>(device, pipeline);
+        return nullptr;
+    }
+
+    // Takes a pipeline that failed to initialize out of the cache, concurrent waiters see its null handle and let go.
+    template<typename Pipeline>
+    inline Pipeline* failPipelineImpl(IDevice* device, Pipeline* pipeline)
+    {
+        TL::LogError("Failed to create pipeline {}", pipeline->getName());
+        device->m_pipelineStateCache.Remove(pipeline, pipeline->cacheKey);
+        pipeline->ready.store(true, std::memory_order_release);
+        if (device->m_pipelineStateCache.Release(pipeline, pipeline->cacheKey))
+            destroyImpl<Pipeline>(device, pipeline);
+        return nullptr;
+    }
+
+    template<typename Pipeline, typename CreateInfo>
+    inline Pipeline* createPipelineImpl(IDevice* device, const CreateInfo& createInfo)
+    {
+        bool      inserted = false;
+        Pipeline* pipeline = device->m_pipelineStateCache.FindOrInsert<Pipeline>(PipelineStateCache::Hash(createInfo), createInfo.name, inserted);
+        if (!inserted)
+            return waitPipelineResult(device, pipeline);
+
+        device->m_pipelineManifest.Record(createInfo);
+        ResultCode result = pipeline->Init(device, createInfo);
+        if (!IsSuccess(result))
+            return failPipelineImpl(device, pipeline);
+        pipeline->ready.store(true, std::memory_order_release);
+        return pipeline;
+    }
+
+    // The pipeline is returned right away and initialized on the pipeline compiler, Desc owns a copy of the create info.
+    template<typename Pipeline, typename Desc, typename CreateInfo>
+    inline Pipeline* createPipelineAsyncImpl(IDevice* device, const CreateInfo& createInfo, PipelineCallback callback, void* userData)
+    {
+        bool      inserted = false;
+        Pipeline* pipeline = device->m_pipelineStateCache.FindOrInsert<Pipeline>(PipelineStateCache::Hash(createInfo), createInfo.name, inserted);
+        if (inserted)
+        {
+            device->m_pipelineManifest.Record(createInfo);
+            device->m_pipelineCompiler.Enqueue(
+                [device, pipeline, desc = Desc(createInfo), callback, userData]() mutable
+                {
+                    ResultCode result = pipeline->Init(device, desc.Resolve());
+                    // The caller keeps its reference, later identical requests must not find the failed pipeline.
+                    if (!IsSuccess(result))
+                        device->m_pipelineStateCache.Remove(pipeline, pipeline->cacheKey);
+                    pipeline->ready.store(true, std::memory_order_release);
+                    if (callback)
+                        callback(result, userData);
+                });
+        }
+        else if (callback)
+        {
+            // The task holds its own reference, the caller may destroy the pipeline before the callback ran.
+            pipeline->addRef();
+            device->m_pipelineCompiler.Enqueue(
+                [device, pipeline, callback, userData]()
+                {
+                    waitPipelineReady(pipeline);
+                    callback(pipeline->handle != VK_NULL_HANDLE ? ResultCode::Success : ResultCode::ErrorUnknown, userData);
+                    if (device->m_pipelineStateCache.Release(pipeline, pipeline->cacheKey))
+                        destroyImpl<Pipeline>(device, pipeline);
+                });
+        }
+        return pipeline;
+    }
+
+    template<typename Pipeline>
+    inline void destroyPipelineImpl(IDevice* device, Pipeline* pipeline)
+    {
+        if (!device->m_pipelineStateCache.Release(pipeline, pipeline->cacheKey))
+            return;
+
+        if (!pipeline->ready.load(std::memory_order_acquire))
+            device->m_pipelineCompiler.WaitIdle();
+        destroyImpl<Pipeline>(device, pipeline);
+    }
+
+    template<typename Pipeline>
+    inline bool isPipelineReadyImpl(const Pipeline* pipeline)
+    {
+        return pipeline->ready.load(std::memory_order_acquire) && pipeline->handle != VK_NULL_HANDLE;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    /// IFrame
+    //////////////////////////////////////////////////////////////////////////////////////////
+
+    ResultCode IFrame::Init(IDevice* device, uint32_t frameIndex)
+    {
+        constexpr const char* QueueNames[] = {"Graphics", "Compute", "Transfer"};
+        static_assert(std::size(QueueNames) == (uint32_t)QueueType::Count);
+
+        for (uint32_t i = 0; i < (uint32_t)QueueType::Count; ++i)
+        {
+            // Queue family not available on this device.
+            if (device->m_queue[i].m_queue == VK_NULL_HANDLE)
+                continue;
+
+            auto name         = TL::fmt("frame[{}] - {}", frameIndex, QueueNames[i]);
+            m_commandPools[i] = createImpl<ICommandPool>(device, name.c_str(), CommandPoolCreateInfo{.name = name.c_str(), .queue = (QueueType)i});
+            if (m_commandPools[i] == nullptr)
+                return ResultCode::ErrorUnknown;
+        }
+        m_transientBindGroups.Init(device);
+        return ResultCode::Success;
+    }
+
+    void IFrame::Shutdown(IDevice* device)
+    {
+        for (auto& commandPool : m_commandPools)
+        {
+            if (commandPool)
+                destroyImpl<ICommandPool>(device, commandPool);
+            commandPool = nullptr;
+        }
+        m_transientBindGroups.Shutdown();
+        m_arena.reset();
+    }
+
+    void IFrame::Recycle(IDevice* device)
+    {
+        ZoneScoped;
+
+        for (auto commandPool : m_commandPools)
+        {
+            if (commandPool)
+                commandPool->Reset();
+        }
+        m_transientBindGroups.Reset();
+        m_arena.reset();
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////
     /// IDevice interface implementation
     //////////////////////////////////////////////////////////////////////////////////////////
 
+    QueueTimelineValues IDevice::GetLastSubmitValues() const
+    {
+        QueueTimelineValues timeline;
+        for (uint32_t i = 0; i < (uint32_t)QueueType::Count; ++i)
+            timeline.values[i] = m_queue[i].m_lastSubmitValue.load();
+        return timeline;
+    }
+
+    QueueTimelineValues IDevice::GetCompletedValues() const
+    {
+        QueueTimelineValues timeline;
+        for (uint32_t i = 0; i < (uint32_t)QueueType::Count; ++i)
+            timeline.values[i] = m_queue[i].GetCompletedValue();
+        return timeline;
+    }
+
     uint64_t IDevice::GarbageCollect(uint64_t graphicsTimeline)
     {
+        // Never release resources a queue may still be using.
+        QueueTimelineValues completed = GetCompletedValues();
+        graphicsTimeline = std::min(graphicsTimeline, completed.values[(uint32_t)QueueType::Graphics]);
+        completed.values[(uint32_t)QueueType::Graphics] = graphicsTimeline;
+
         m_arena.reset();
-        m_destroyQueue->Flush(this, graphicsTimeline);
+        m_destroyQueue->Flush(this, completed);
+        m_bindlessHeap.Reclaim(graphicsTimeline);
         return graphicsTimeline;
     }
 
@@ -1045,14 +1517,214 @@ namespace RHI::Vulkan
         return &m_queue[(int)queueType];
     }
 
+    uint32_t IDevice::GetFramesInFlightCount() const
+    {
+        return m_framesInFlight;
+    }
+
+    uint32_t IDevice::BeginFrame()
+    {
+        ZoneScoped;
+
+        IFrame& frame = CurrentFrame();
+
+        // Block until the GPU retired the last submissions recorded from this slot.
+        for (uint32_t i = 0; i < (uint32_t)QueueType::Count; ++i)
+        {
+            IQueue&  queue = m_queue[i];
+            uint64_t value = frame.m_timelineValues[i];
+            if (value != 0 && queue.GetCompletedValue() < value)
+                queue.WaitFence(&queue.m_timeline, value);
+        }
+
+        frame.Recycle(this);
+
+        {
+            std::lock_guard lock(m_dynamicRingMutex);
+            m_dynamicRing.Reclaim(m_queue[(uint32_t)QueueType::Graphics].GetCompletedValue());
+        }
+
+        // Uploads issued during the previous frame become visible to the work recorded from now on.
+        m_uploadEngine->Poll();
+        m_uploadEngine->Flush();
+
+        GarbageCollect(UINT64_MAX);
+        return m_frameIndex;
+    }
+
+    uint64_t IDevice::EndFrame()
+    {
+        ZoneScoped;
+
+        IFrame& frame = CurrentFrame();
+        for (uint32_t i = 0; i < (uint32_t)QueueType::Count; ++i)
+            frame.m_timelineValues[i] = m_queue[i].m_lastSubmitValue.load();
+
+        {
+            std::lock_guard lock(m_dynamicRingMutex);
+            m_dynamicRing.Retire(frame.m_timelineValues[(uint32_t)QueueType::Graphics]);
+        }
+        m_bindlessHeap.Retire(frame.m_timelineValues[(uint32_t)QueueType::Graphics]);
+        m_bindGroupCache.Evict();
+
+        m_frameIndex = (m_frameIndex + 1) % m_framesInFlight;
+        return frame.m_timelineValues[(uint32_t)QueueType::Graphics];
+    }
+
+    CommandPool* IDevice::GetFrameCommandPool(QueueType queueType)
+    {
+        ICommandPool* commandPool = CurrentFrame().m_commandPools[(uint32_t)queueType];
+        TL_ASSERT(commandPool, "Queue is not available on this device");
+        return commandPool;
+    }
+
+    uint64_t IDevice::UploadBuffer(const BufferUploadInfo& uploadInfo)
+    {
+        return m_uploadEngine->UploadBuffer(uploadInfo);
+    }
+
+    uint64_t IDevice::UploadImage(const ImageUploadInfo& uploadInfo)
+    {
+        return m_uploadEngine->UploadImage(uploadInfo);
+    }
+
+    uint64_t IDevice::FlushUploads()
+    {
+        uint64_t value = m_uploadEngine->Flush();
+        m_uploadEngine->Poll();
+        return value;
+    }
+
+    Fence* IDevice::GetUploadFence()
+    {
+        return m_uploadEngine->m_fence;
+    }
+
+    ResultCode IDevice::SavePipelineCache()
+    {
+        return m_pipelineCache.Save(this);
+    }
+
+    ResultCode IDevice::SavePipelineManifest()
+    {
+        return m_pipelineManifest.Save();
+    }
+
+    ResultCode IDevice::PrecompilePipelines(const char* manifestPath, uint32_t threadCount)
+    {
+        ZoneScoped;
+
+        auto start = std::chrono::steady_clock::now();
+
+        PipelineManifest::Entries entries;
+        if (auto result = m_pipelineManifest.Load(manifestPath, m_shaderModuleCache, entries); IsError(result))
+            return result;
+
+        size_t graphicsCount = entries.graphics.size();
+        size_t computeCount  = entries.compute.size();
+        size_t totalCount    = graphicsCount + computeCount + entries.rayTracing.size();
+
+        TL::Vector<IGraphicsPipeline*>   graphicsPipelines(graphicsCount);
+        TL::Vector<IComputePipeline*>    computePipelines(computeCount);
+        TL::Vector<IRayTracingPipeline*> rayTracingPipelines(entries.rayTracing.size());
+
+        // Threads pick entries in turn and share the pipeline cache, pipelines also recorded this run are cache hits.
+        std::atomic_size_t nextEntry = 0;
+        auto               worker    = [&]()
+        {
+            tracy::SetThreadName("Pipeline precompiler");
+            for (size_t i = nextEntry++; i < totalCount; i = nextEntry++)
+            {
+                if (i < graphicsCount)
+                    graphicsPipelines[i] = createPipelineImpl<IGraphicsPipeline>(this, entries.graphics[i].Resolve());
+                else if (i < graphicsCount + computeCount)
+                    computePipelines[i - graphicsCount] = createPipelineImpl<IComputePipeline>(this, entries.compute[i - graphicsCount].Resolve());
+                else
+                    rayTracingPipelines[i - graphicsCount - computeCount] = createPipelineImpl<IRayTracingPipeline>(this, entries.rayTracing[i - graphicsCount - computeCount].Resolve());
+            }
+        };
+
+        if (threadCount == 0)
+            threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        threadCount = uint32_t(std::min<size_t>(threadCount, totalCount));
+
+        TL::Vector<std::thread> threads;
+        for (uint32_t i = 0; i < threadCount; ++i)
+            threads.emplace_back(worker);
+        for (auto& thread : threads)
+            thread.join();
+
+        // Failed entries were already logged and dropped from the state cache, only successes are kept alive.
+        size_t failedCount = 0;
+        auto   keep        = [&failedCount](auto& precompiled, const auto& pipelines)
+        {
+            for (auto pipeline : pipelines)
+            {
+                if (pipeline)
+                    precompiled.push_back(pipeline);
+                else
+                    failedCount++;
+            }
+        };
+        keep(m_precompiledGraphicsPipelines, graphicsPipelines);
+        keep(m_precompiledComputePipelines, computePipelines);
+        keep(m_precompiledRayTracingPipelines, rayTracingPipelines);
+
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        TL::LogInfo("Pipeline manifest: precompiled {} pipelines in {:.2f} ms on {} threads, {} failed, skipped {} with missing shader modules or layouts", totalCount - failedCount, elapsed, threadCount, failedCount, entries.unresolvedCount);
+        return ResultCode::Success;
+    }
+
+    void IDevice::ReleasePrecompiledPipelines()
+    {
+        for (auto pipeline : m_precompiledGraphicsPipelines)
+            destroyPipelineImpl(this, pipeline);
+        for (auto pipeline : m_precompiledComputePipelines)
+            destroyPipelineImpl(this, pipeline);
+        for (auto pipeline : m_precompiledRayTracingPipelines)
+            destroyPipelineImpl(this, pipeline);
+        m_precompiledGraphicsPipelines.clear();
+        m_precompiledComputePipelines.clear();
+        m_precompiledRayTracingPipelines.clear();
+    }
+
     ShaderModule* IDevice::CreateShaderModule(const ShaderModuleCreateInfo& createInfo)
     {
-        return createImpl<IShaderModule>(this, createInfo.name, createInfo);
+        ZoneScoped;
+
+        uint64_t key = ShaderModuleCache::Hash(createInfo.code);
+        if (auto shaderModule = m_shaderModuleCache.Find(key))
+            return shaderModule;
+
+        // Created outside the cache's lock, on a race the module inserted first wins.
+        auto shaderModule = createImpl<IShaderModule>(this, createInfo.name, createInfo);
+        if (auto cached = m_shaderModuleCache.Insert(key, shaderModule); cached != shaderModule)
+        {
+            destroyImpl<IShaderModule>(this, shaderModule);
+            return cached;
+        }
+        return shaderModule;
     }
 
     void IDevice::DestroyShaderModule(ShaderModule* resource)
     {
-        destroyImpl<IShaderModule>(this, (IShaderModule*)resource);
+        if (m_shaderModuleCache.Release((IShaderModule*)resource))
+            destroyImpl<IShaderModule>(this, (IShaderModule*)resource);
+    }
+
+    ShaderObject* IDevice::CreateShaderObject(const ShaderObjectCreateInfo& createInfo)
+    {
+        if (!m_features.hasShaderObject)
+        {
+            TL::LogError("Shader objects are not supported by this device");
+            return nullptr;
+        }
+        return createImpl<IShaderObject>(this, createInfo.name, createInfo);
+    }
+
+    void IDevice::DestroyShaderObject(ShaderObject* resource)
+    {
+        destroyImpl<IShaderObject>(this, (IShaderObject*)resource);
     }
 
     BindGroupLayout* IDevice::CreateBindGroupLayout(const BindGroupLayoutCreateInfo& createInfo)
@@ -1072,54 +1744,120 @@ namespace RHI::Vulkan
 
     void IDevice::DestroyBindGroup(BindGroup* resource)
     {
-        destroyImpl<IBindGroup>(this, (IBindGroup*)resource);
+        auto bindGroup = (IBindGroup*)resource;
+        TL_ASSERT(!bindGroup->transient, "Transient bind groups are released with their frame");
+        if (bindGroup->cached)
+            m_bindGroupCache.Release(bindGroup);
+        else
+            destroyImpl<IBindGroup>(this, bindGroup);
+    }
+
+    BindGroup* IDevice::CreateTransientBindGroup(const BindGroupCreateInfo& createInfo)
+    {
+        return CurrentFrame().m_transientBindGroups.Allocate(createInfo);
+    }
+
+    BindGroup* IDevice::CreateCachedBindGroup(const BindGroupCreateInfo& createInfo, const BindGroupUpdateInfo& updateInfo)
+    {
+        ZoneScoped;
+
+        if (m_bindGroupCache.IsEnabled())
+            return m_bindGroupCache.FindOrCreate(createInfo, updateInfo);
+
+        auto bindGroup = createImpl<IBindGroup>(this, createInfo.name, createInfo);
+        bindGroup->Update(this, updateInfo);
+        return bindGroup;
+    }
+
+    BindGroupCacheStats IDevice::GetBindGroupCacheStats()
+    {
+        return m_bindGroupCache.GetStats();
     }
 
     void IDevice::UpdateBindGroup(BindGroup* handle, const BindGroupUpdateInfo& updateInfo)
     {
         ZoneScoped;
         auto bindGroup = (IBindGroup*)(handle);
+        TL_ASSERT(!bindGroup->cached, "Cached bind groups are shared and must not be updated");
         bindGroup->Update(this, updateInfo);
     }
 
+    BindGroupLayout* IDevice::GetBindlessBindGroupLayout()
+    {
+        return m_bindlessHeap.GetLayout();
+    }
+
+    uint32_t IDevice::RegisterImage(Image* image)
+    {
+        return m_bindlessHeap.RegisterImage(image);
+    }
+
+    uint32_t IDevice::RegisterBuffer(Buffer* buffer)
+    {
+        return m_bindlessHeap.RegisterBuffer(buffer);
+    }
+
+    uint32_t IDevice::RegisterSampler(Sampler* sampler)
+    {
+        return m_bindlessHeap.RegisterSampler(sampler);
+    }
+
+    void IDevice::UnregisterImage(uint32_t index)
+    {
+        m_bindlessHeap.Unregister(BindlessHeap::Images, index);
+    }
+
+    void IDevice::UnregisterBuffer(uint32_t index)
+    {
+        m_bindlessHeap.Unregister(BindlessHeap::Buffers, index);
+    }
+
+    void IDevice::UnregisterSampler(uint32_t index)
+    {
+        m_bindlessHeap.Unregister(BindlessHeap::Samplers, index);
+    }
+
     PipelineLayout* IDevice::CreatePipelineLayout(const PipelineLayoutCreateInfo& createInfo)
     {
-        return createImpl<IPipelineLayout>(this, createInfo.name, createInfo);
+        auto layout = createImpl<IPipelineLayout>(this, createInfo.name, createInfo);
+        m_pipelineManifest.AddPipelineLayout(layout);
+        return layout;
     }
 
     void IDevice::DestroyPipelineLayout(PipelineLayout* resource)
     {
+        m_pipelineManifest.RemovePipelineLayout((IPipelineLayout*)resource);
         destroyImpl<IPipelineLayout>(this, (IPipelineLayout*)resource);
     }
 
     GraphicsPipeline* IDevice::CreateGraphicsPipeline(const GraphicsPipelineCreateInfo& createInfo)
     {
-        return createImpl<IGraphicsPipeline>(this, createInfo.name, createInfo);
+        return createPipelineImpl<IGraphicsPipeline>(this, createInfo);
     }
 
     void IDevice::DestroyGraphicsPipeline(GraphicsPipeline* resource)
     {
-        destroyImpl<IGraphicsPipeline>(this, (IGraphicsPipeline*)resource);
+        destroyPipelineImpl<IGraphicsPipeline>(this, (IGraphicsPipeline*)resource);
     }
 
     ComputePipeline* IDevice::CreateComputePipeline(const ComputePipelineCreateInfo& createInfo)
     {
-        return createImpl<IComputePipeline>(this, createInfo.name, createInfo);
+        return createPipelineImpl<IComputePipeline>(this, createInfo);
     }
 
     void IDevice::DestroyComputePipeline(ComputePipeline* resource)
     {
-        destroyImpl<IComputePipeline>(this, (IComputePipeline*)resource);
+        destroyPipelineImpl<IComputePipeline>(this, (IComputePipeline*)resource);
     }
 
     RayTracingPipeline* IDevice::CreateRayTracingPipeline(const RayTracingPipelineCreateInfo& createInfo)
     {
-        return createImpl<IRayTracingPipeline>(this, createInfo.name, createInfo);
+        return createPipelineImpl<IRayTracingPipeline>(this, createInfo);
     }
 
     void IDevice::DestroyRayTracingPipeline(RayTracingPipeline* resource)
     {
-        destroyImpl<IRayTracingPipeline>(this, (IRayTracingPipeline*)resource);
+        destroyPipelineImpl<IRayTracingPipeline>(this, (IRayTracingPipeline*)resource);
     }
 
     void IDevice::GetShaderBindingTableEntry(RayTracingPipeline* handle, uint32_t group, size_t size, void* dstHandle)
@@ -1127,6 +1865,98 @@ namespace RHI::Vulkan
         return ((IRayTracingPipeline*)handle)->GetShaderBindingTableEntry(this, group, size, dstHandle);
     }
 
+    GraphicsPipeline* IDevice::CreateGraphicsPipelineAsync(const GraphicsPipelineCreateInfo& createInfo, PipelineCallback callback, void* userData)
+    {
+        return createPipelineAsyncImpl<IGraphicsPipeline, GraphicsPipelineDesc>(this, createInfo, callback, userData);
+    }
+
+    ComputePipeline* IDevice::CreateComputePipelineAsync(const ComputePipelineCreateInfo& createInfo, PipelineCallback callback, void* userData)
+    {
+        return createPipelineAsyncImpl<IComputePipeline, ComputePipelineDesc>(this, createInfo, callback, userData);
+    }
+
+    RayTracingPipeline* IDevice::CreateRayTracingPipelineAsync(const RayTracingPipelineCreateInfo& createInfo, PipelineCallback callback, void* userData)
+    {
+        return createPipelineAsyncImpl<IRayTracingPipeline, RayTracingPipelineDesc>(this, createInfo, callback, userData);
+    }
+
+    bool IDevice::IsPipelineReady(const GraphicsPipeline* handle)
+    {
+        return isPipelineReadyImpl((const IGraphicsPipeline*)handle);
+    }
+
+    bool IDevice::IsPipelineReady(const ComputePipeline* handle)
+    {
+        return isPipelineReadyImpl((const IComputePipeline*)handle);
+    }
+
+    bool IDevice::IsPipelineReady(const RayTracingPipeline* handle)
+    {
+        return isPipelineReadyImpl((const IRayTracingPipeline*)handle);
+    }
+
+    PipelineCacheStats IDevice::GetPipelineCacheStats()
+    {
+        return m_pipelineStateCache.GetStats();
+    }
+
+    uint32_t IDevice::GetPipelineStats(TL::Span<PipelineStats> stats)
+    {
+        return m_pipelineCache.GetStats(stats);
+    }
+
+    GraphicsPipelineLibrary* IDevice::CreateGraphicsPipelineLibrary(const GraphicsPipelineLibraryCreateInfo& createInfo)
+    {
+        if (!m_features.hasGraphicsPipelineLibrary)
+        {
+            TL::LogError("Graphics pipeline libraries are not supported by this device");
+            return nullptr;
+        }
+        return createImpl<IGraphicsPipelineLibrary>(this, createInfo.name, createInfo);
+    }
+
+    void IDevice::DestroyGraphicsPipelineLibrary(GraphicsPipelineLibrary* resource)
+    {
+        // Pending link time optimizations hold a reference to their libraries.
+        if (resource->release())
+            destroyImpl<IGraphicsPipelineLibrary>(this, (IGraphicsPipelineLibrary*)resource);
+    }
+
+    GraphicsPipeline* IDevice::LinkGraphicsPipeline(const GraphicsPipelineLinkInfo& linkInfo)
+    {
+        bool               inserted = false;
+        IGraphicsPipeline* pipeline = m_pipelineStateCache.FindOrInsert<IGraphicsPipeline>(PipelineStateCache::Hash(linkInfo), linkInfo.name, inserted);
+        if (!inserted)
+            return waitPipelineResult(this, pipeline);
+
+        ResultCode result = pipeline->Link(this, linkInfo, false);
+        if (!IsSuccess(result))
+            return failPipelineImpl(this, pipeline);
+        pipeline->ready.store(true, std::memory_order_release);
+
+        if (linkInfo.optimize)
+        {
+            // The fast linked pipeline is usable right away, the optimized one replaces it once compiled.
+            // The task holds references to the pipeline and its libraries, either may be destroyed meanwhile.
+            pipeline->addRef();
+            TL::Vector<GraphicsPipelineLibrary*> libraries(linkInfo.libraries.begin(), linkInfo.libraries.end());
+            for (auto library : libraries)
+                library->addRef();
+
+            m_pipelineCompiler.Enqueue(
+                [this, pipeline, libraries = std::move(libraries), layout = linkInfo.layout]()
+                {
+                    (void)pipeline->Link(this, {.libraries = libraries, .layout = layout}, true);
+
+                    if (m_pipelineStateCache.Release(pipeline, pipeline->cacheKey))
+                        destroyImpl<IGraphicsPipeline>(this, pipeline);
+                    for (auto library : libraries)
+                        DestroyGraphicsPipelineLibrary(library);
+                });
+        }
+        return pipeline;
+    }
+
     Buffer* IDevice::CreateBuffer(const BufferCreateInfo& createInfo)
     {
         return createImpl<IBuffer>(this, createInfo.name, createInfo);
@@ -1147,7 +1977,7 @@ namespace RHI::Vulkan
     DeviceMemoryPtr IDevice::MapBuffer(Buffer* _buffer, uint64_t offset, uint64_t sizeBytes)
     {
         IBuffer* buffer = (IBuffer*)_buffer;
-        return buffer->Map(this);
+        return buffer->Map(this, offset);
     }
 
     void IDevice::UnmapBuffer(Buffer* _buffer)
@@ -1156,6 +1986,33 @@ namespace RHI::Vulkan
         buffer->Unmap(this);
     }
 
+    DynamicAllocation IDevice::AllocateDynamic(size_t size, size_t alignment)
+    {
+        if (alignment == 0)
+            alignment = std::max(m_limits.minUniformBufferOffsetAlignment, m_limits.minStorageBufferOffsetAlignment);
+
+        std::lock_guard lock(m_dynamicRingMutex);
+
+        StagingRing::Allocation allocation;
+        while (!m_dynamicRing.Allocate(size, alignment, allocation))
+        {
+            // Regions of older frames are normally reclaimed in BeginFrame, only block when they are still in flight.
+            if (!m_dynamicRing.HasRetiredRegions())
+            {
+                TL::LogError("AllocateDynamic: {} bytes do not fit in the dynamic ring, increase ApplicationInfo::dynamicMemorySize", size);
+                return {};
+            }
+
+            IQueue&  graphicsQueue = m_queue[(uint32_t)QueueType::Graphics];
+            uint64_t oldestValue   = m_dynamicRing.GetOldestRetiredValue();
+            if (graphicsQueue.GetCompletedValue() < oldestValue)
+                graphicsQueue.WaitFence(&graphicsQueue.m_timeline, oldestValue);
+            m_dynamicRing.Reclaim(graphicsQueue.GetCompletedValue());
+        }
+
+        return {.buffer = allocation.buffer, .offset = allocation.offset, .ptr = allocation.ptr};
+    }
+
     Image* IDevice::CreateImage(const ImageCreateInfo& createInfo)
     {
         return createImpl<IImage>(this, createInfo.name, createInfo);
@@ -1171,6 +2028,31 @@ namespace RHI::Vulkan
         destroyImpl<IImage>(this, (IImage*)resource);
     }
 
+    TransientHeap* IDevice::CreateTransientHeap(const TransientHeapCreateInfo& createInfo)
+    {
+        return createImpl<ITransientHeap>(this, createInfo.name, createInfo);
+    }
+
+    void IDevice::DestroyTransientHeap(TransientHeap* handle)
+    {
+        destroyImpl<ITransientHeap>(this, (ITransientHeap*)handle);
+    }
+
+    Image* IDevice::GetTransientImage(TransientHeap* handle, uint32_t index)
+    {
+        return ((ITransientHeap*)handle)->images[index];
+    }
+
+    Buffer* IDevice::GetTransientBuffer(TransientHeap* handle, uint32_t index)
+    {
+        return ((ITransientHeap*)handle)->buffers[index];
+    }
+
+    TransientHeapStats IDevice::GetTransientHeapStats(TransientHeap* handle)
+    {
+        return ((ITransientHeap*)handle)->stats;
+    }
+
     Sampler* IDevice::CreateSampler(const SamplerCreateInfo& createInfo)
     {
         return createImpl<ISampler>(this, createInfo.name, createInfo);
@@ -1292,7 +2174,9 @@ namespace RHI::Vulkan
 
     void DeleteQueue::shutdown(IDevice* device)
     {
-        Flush(device, UINT64_MAX);
+        QueueTimelineValues completed;
+        std::fill(std::begin(completed.values), std::end(completed.values), UINT64_MAX);
+        Flush(device, completed);
         TL_ASSERT(m_allocation.empty());
         TL_ASSERT(m_buffer.empty());
         TL_ASSERT(m_bufferView.empty());
@@ -1301,12 +2185,15 @@ namespace RHI::Vulkan
         TL_ASSERT(m_sampler.empty());
         TL_ASSERT(m_pipeline.empty());
         TL_ASSERT(m_descriptorPool.empty());
+        TL_ASSERT(m_descriptorSet.empty());
+        TL_ASSERT(m_descriptorRange.empty());
         TL_ASSERT(m_queryPool.empty());
         TL_ASSERT(m_swapchain.empty());
         TL_ASSERT(m_surface.empty());
         TL_ASSERT(m_semaphore.empty());
         TL_ASSERT(m_accelerationStructure.empty());
         TL_ASSERT(m_micromap.empty());
+        TL_ASSERT(m_shader.empty());
         TL_ASSERT(m_pending.empty());
     }
 
@@ -1321,12 +2208,15 @@ namespace RHI::Vulkan
         else if constexpr (std::is_same_v<VkSampler, ResourceType>) vkDestroySampler(device->m_device, handle, nullptr);
         else if constexpr (std::is_same_v<VkPipeline, ResourceType>) vkDestroyPipeline(device->m_device, handle, nullptr);
         else if constexpr (std::is_same_v<VkDescriptorPool, ResourceType>) vkDestroyDescriptorPool(device->m_device, handle, nullptr);
+        else if constexpr (std::is_same_v<VkDescriptorSet, ResourceType>) vkFreeDescriptorSets(device->m_device, device->m_bindGroupAllocator.m_descriptorPool, 1, &handle);
+        else if constexpr (std::is_same_v<VmaVirtualAllocation, ResourceType>) device->m_bindGroupAllocator.FreeDescriptorRange(handle);
         else if constexpr (std::is_same_v<VkQueryPool, ResourceType>) vkDestroyQueryPool(device->m_device, handle, nullptr);
         else if constexpr (std::is_same_v<VkSemaphore, ResourceType>) vkDestroySemaphore(device->m_device, handle, nullptr);
         else if constexpr (std::is_same_v<VkSwapchainKHR, ResourceType>) vkDestroySwapchainKHR(device->m_device, handle, nullptr);
         else if constexpr (std::is_same_v<VkSurfaceKHR, ResourceType>) vkDestroySurfaceKHR(device->m_instance, handle, nullptr);
         else if constexpr (std::is_same_v<VkAccelerationStructureKHR, ResourceType>) vkDestroyAccelerationStructureKHR(device->m_device, handle, nullptr);
         else if constexpr (std::is_same_v<VkMicromapEXT, ResourceType>) vkDestroyMicromapEXT(device->m_device, handle, nullptr);
+        else if constexpr (std::is_same_v<VkShaderEXT, ResourceType>) vkDestroyShaderEXT(device->m_device, handle, nullptr);
         else if constexpr (std::is_same_v<VmaBufferAllocation, ResourceType>) vmaDestroyBuffer(device->m_deviceAllocator, handle.first, handle.second);
         else if constexpr (std::is_same_v<VmaImageAllocation, ResourceType>) vmaDestroyImage(device->m_deviceAllocator, handle.first, handle.second);
         else
@@ -1336,12 +2226,12 @@ namespace RHI::Vulkan
     }
 
     template<typename ResourceType>
-    void DeleteQueue::FlushQueue(IDevice* device, TL::Vector<ResourceDeleteQueueEntry<ResourceType>>& queue, uint64_t timeline)
+    void DeleteQueue::FlushQueue(IDevice* device, TL::Vector<ResourceDeleteQueueEntry<ResourceType>>& queue, const QueueTimelineValues& completed)
     {
         uint32_t deleteCount = 0;
         for (const auto& entry : queue)
         {
-            if (entry.timeline > timeline)
+            if (!entry.timeline.IsCompleted(completed))
                 break;
 
             destroyVkResource(device, entry.resource);
@@ -1355,23 +2245,28 @@ namespace RHI::Vulkan
         queue.erase(queue.begin(), queue.begin() + deleteCount);
     }
 
-    void DeleteQueue::Flush(IDevice* device, uint64_t timeline)
+    void DeleteQueue::Flush(IDevice* device, const QueueTimelineValues& completed)
     {
+        std::lock_guard lock(m_mutex);
+
         // flush in an order that is safe: destroy child objects before parents
-        FlushQueue(device, m_bufferView, timeline);
-        FlushQueue(device, m_imageView, timeline);
-        FlushQueue(device, m_descriptorPool, timeline);
-        FlushQueue(device, m_queryPool, timeline);
-        FlushQueue(device, m_pipeline, timeline);
-        FlushQueue(device, m_sampler, timeline);
-        FlushQueue(device, m_buffer, timeline);
-        FlushQueue(device, m_image, timeline);
-        FlushQueue(device, m_swapchain, timeline);
-        FlushQueue(device, m_surface, timeline);
-        FlushQueue(device, m_semaphore, timeline);
-        FlushQueue(device, m_accelerationStructure, timeline);
-        FlushQueue(device, m_micromap, timeline);
-        FlushQueue(device, m_allocation, timeline);
+        FlushQueue(device, m_bufferView, completed);
+        FlushQueue(device, m_imageView, completed);
+        FlushQueue(device, m_descriptorSet, completed);
+        FlushQueue(device, m_descriptorRange, completed);
+        FlushQueue(device, m_descriptorPool, completed);
+        FlushQueue(device, m_queryPool, completed);
+        FlushQueue(device, m_pipeline, completed);
+        FlushQueue(device, m_shader, completed);
+        FlushQueue(device, m_sampler, completed);
+        FlushQueue(device, m_buffer, completed);
+        FlushQueue(device, m_image, completed);
+        FlushQueue(device, m_swapchain, completed);
+        FlushQueue(device, m_surface, completed);
+        FlushQueue(device, m_semaphore, completed);
+        FlushQueue(device, m_accelerationStructure, completed);
+        FlushQueue(device, m_micromap, completed);
+        FlushQueue(device, m_allocation, completed);
     }
 
 } // namespace RHI::Vulkan
\ No newline at end of file
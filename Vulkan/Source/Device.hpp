@@ -15,9 +15,16 @@
 #include <volk.h>
 #include <vk_mem_alloc.h>
 
+#include <mutex>
+
+#include "BindGroupCache.hpp"
+#include "BindlessHeap.hpp"
 #include "Common.hpp"
 #include "Resources.hpp"
 #include "CommandList.hpp"
+#include "PipelineCache.hpp"
+#include "PipelineCompiler.hpp"
+#include "Upload.hpp"
 
 namespace RHI::Vulkan
 {
@@ -27,18 +34,66 @@ namespace RHI::Vulkan
         VkResult Init(IDevice* device, const char* debugName, uint32_t familyIndex, uint32_t queueIndex);
         void     Shutdown();
 
-        void BeginAnnotation(const char* name, uint32_t bgra) override;
-        void EndAnnotation() override;
-        void InsertAnnotation(const char* name, uint32_t bgra) override;
-        void Submit(const QueueSubmitInfo& submitInfo) override;
-        void WaitIdle() override;
-        void WaitFence(Fence* fence, uint64_t value) override;
+        void     BeginAnnotation(const char* name, uint32_t bgra) override;
+        void     EndAnnotation() override;
+        void     InsertAnnotation(const char* name, uint32_t bgra) override;
+        uint64_t Submit(const QueueSubmitInfo& submitInfo) override;
+        uint64_t SubmitBatch(TL::Span<const QueueSubmitInfo> submitInfos) override;
+        void     Present(TL::Span<Swapchain* const> swapchains) override;
+        Fence*   GetTimelineFence() override;
+        void     WaitIdle() override;
+        void     WaitFence(Fence* fence, uint64_t value) override;
+
+        // Returns the last timeline value the GPU has finished on this queue.
+        uint64_t GetCompletedValue() const;
 
         IDevice*             m_device;
         VkQueue              m_queue;
         uint32_t             m_familyIndex;
         QueueType            m_queueType;
+        // Timeline semaphore signaled with m_lastSubmitValue on every submission.
+        IFence               m_timeline;
         std::atomic_uint64_t m_lastSubmitValue;
+        // VkQueue access must be externally synchronized. Queues aliasing another queue's VkQueue point at its lock.
+        std::mutex           m_ownMutex;
+        std::mutex*          m_mutex = &m_ownMutex;
+        // Scratch for SubmitBatch and Present, reset on each call while m_mutex is held.
+        TL::Arena            m_arena;
+    };
+
+    // One value per queue timeline. Resources pushed to the delete queue record the last value submitted to every
+    // queue, they may still be used by any of them and are destroyed once all of these values completed.
+    struct QueueTimelineValues
+    {
+        uint64_t values[(uint32_t)QueueType::Count] = {};
+
+        bool IsCompleted(const QueueTimelineValues& completed) const
+        {
+            for (uint32_t i = 0; i < (uint32_t)QueueType::Count; ++i)
+            {
+                if (values[i] > completed.values[i])
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    // Per frame-in-flight slot, owns transient resources that are recycled once the GPU retired the frame.
+    class IFrame
+    {
+    public:
+        ResultCode Init(IDevice* device, uint32_t frameIndex);
+        void       Shutdown(IDevice* device);
+
+        // Resets every transient resource, must only be called once the GPU retired m_timelineValues.
+        void       Recycle(IDevice* device);
+
+        // Last value submitted to each queue timeline while this frame was being recorded.
+        uint64_t      m_timelineValues[(uint32_t)QueueType::Count] = {};
+        ICommandPool* m_commandPools[(uint32_t)QueueType::Count]   = {};
+        TL::Arena     m_arena;
+        // Backs CreateTransientBindGroup, reset wholesale in Recycle.
+        TransientBindGroupAllocator m_transientBindGroups;
     };
 
     class IDevice final : public RHI::Device
@@ -70,16 +125,48 @@ namespace RHI::Vulkan
 
         void WaitIdle();
 
+        // Drops the references PrecompilePipelines holds.
+        void ReleasePrecompiledPipelines();
+
+        IFrame& CurrentFrame() { return m_frames[m_frameIndex]; }
+
+        // Last submitted and last completed value of each queue timeline.
+        QueueTimelineValues GetLastSubmitValues() const;
+        QueueTimelineValues GetCompletedValues() const;
+
         uint64_t                       GarbageCollect(uint64_t graphicsTimeline) override;
         uint64_t                       GetNativeHandle(NativeHandleType type, uint64_t handle) override;
         Queue*                         GetQueue(QueueType queueType) override;
+        uint32_t                       GetFramesInFlightCount() const override;
+        uint32_t                       BeginFrame() override;
+        uint64_t                       EndFrame() override;
+        CommandPool*                   GetFrameCommandPool(QueueType queueType) override;
+        uint64_t                       UploadBuffer(const BufferUploadInfo& uploadInfo) override;
+        uint64_t                       UploadImage(const ImageUploadInfo& uploadInfo) override;
+        uint64_t                       FlushUploads() override;
+        Fence*                         GetUploadFence() override;
+        ResultCode                     SavePipelineCache() override;
+        ResultCode                     SavePipelineManifest() override;
+        ResultCode                     PrecompilePipelines(const char* manifestPath, uint32_t threadCount) override;
         ShaderModule*                  CreateShaderModule(const ShaderModuleCreateInfo& createInfo) override;
         void                           DestroyShaderModule(ShaderModule* shaderModule) override;
+        ShaderObject*                  CreateShaderObject(const ShaderObjectCreateInfo& createInfo) override;
+        void                           DestroyShaderObject(ShaderObject* handle) override;
         BindGroupLayout*               CreateBindGroupLayout(const BindGroupLayoutCreateInfo& createInfo) override;
         void                           DestroyBindGroupLayout(BindGroupLayout* handle) override;
         BindGroup*                     CreateBindGroup(const BindGroupCreateInfo& createInfo) override;
         void                           DestroyBindGroup(BindGroup* handle) override;
+        BindGroup*                     CreateTransientBindGroup(const BindGroupCreateInfo& createInfo) override;
+        BindGroup*                     CreateCachedBindGroup(const BindGroupCreateInfo& createInfo, const BindGroupUpdateInfo& updateInfo) override;
+        BindGroupCacheStats            GetBindGroupCacheStats() override;
         void                           UpdateBindGroup(BindGroup* handle, const BindGroupUpdateInfo& updateInfo) override;
+        BindGroupLayout*               GetBindlessBindGroupLayout() override;
+        uint32_t                       RegisterImage(Image* image) override;
+        uint32_t                       RegisterBuffer(Buffer* buffer) override;
+        uint32_t                       RegisterSampler(Sampler* sampler) override;
+        void                           UnregisterImage(uint32_t index) override;
+        void                           UnregisterBuffer(uint32_t index) override;
+        void                           UnregisterSampler(uint32_t index) override;
         PipelineLayout*                CreatePipelineLayout(const PipelineLayoutCreateInfo& createInfo) override;
         void                           DestroyPipelineLayout(PipelineLayout* handle) override;
         GraphicsPipeline*              CreateGraphicsPipeline(const GraphicsPipelineCreateInfo& createInfo) override;
@@ -89,14 +176,31 @@ namespace RHI::Vulkan
         RayTracingPipeline*            CreateRayTracingPipeline(const RayTracingPipelineCreateInfo& createInfo) override;
         void                           DestroyRayTracingPipeline(RayTracingPipeline* handle) override;
         void                           GetShaderBindingTableEntry(RayTracingPipeline* handle, uint32_t group, size_t size, void* dstHandle) override;
+        GraphicsPipeline*              CreateGraphicsPipelineAsync(const GraphicsPipelineCreateInfo& createInfo, PipelineCallback callback, void* userData) override;
+        ComputePipeline*               CreateComputePipelineAsync(const ComputePipelineCreateInfo& createInfo, PipelineCallback callback, void* userData) override;
+        RayTracingPipeline*            CreateRayTracingPipelineAsync(const RayTracingPipelineCreateInfo& createInfo, PipelineCallback callback, void* userData) override;
+        bool                           IsPipelineReady(const GraphicsPipeline* handle) override;
+        bool                           IsPipelineReady(const ComputePipeline* handle) override;
+        bool                           IsPipelineReady(const RayTracingPipeline* handle) override;
+        PipelineCacheStats             GetPipelineCacheStats() override;
+        uint32_t                       GetPipelineStats(TL::Span<PipelineStats> stats) override;
+        GraphicsPipelineLibrary*       CreateGraphicsPipelineLibrary(const GraphicsPipelineLibraryCreateInfo& createInfo) override;
+        void                           DestroyGraphicsPipelineLibrary(GraphicsPipelineLibrary* handle) override;
+        GraphicsPipeline*              LinkGraphicsPipeline(const GraphicsPipelineLinkInfo& linkInfo) override;
         Buffer*                        CreateBuffer(const BufferCreateInfo& createInfo) override;
         void                           DestroyBuffer(Buffer* handle) override;
         uint64_t                       GetBufferDeviceAddress(Buffer* buffer) override;
         DeviceMemoryPtr                MapBuffer(Buffer* buffer, uint64_t offset, uint64_t sizeBytes) override;
         void                           UnmapBuffer(Buffer* buffer) override;
+        DynamicAllocation              AllocateDynamic(size_t size, size_t alignment) override;
         Image*                         CreateImage(const ImageCreateInfo& createInfo) override;
         Image*                         CreateImageView(const ImageViewCreateInfo& createInfo) override;
         void                           DestroyImage(Image* handle) override;
+        TransientHeap*                 CreateTransientHeap(const TransientHeapCreateInfo& createInfo) override;
+        void                           DestroyTransientHeap(TransientHeap* handle) override;
+        Image*                         GetTransientImage(TransientHeap* handle, uint32_t index) override;
+        Buffer*                        GetTransientBuffer(TransientHeap* handle, uint32_t index) override;
+        TransientHeapStats             GetTransientHeapStats(TransientHeap* handle) override;
         Sampler*                       CreateSampler(const SamplerCreateInfo& createInfo) override;
         void                           DestroySampler(Sampler* handle) override;
         AccelerationStructure*         CreateAccelerationStructure(const AccelerationStructureCreateInfo& createInfo) override;
@@ -122,15 +226,40 @@ namespace RHI::Vulkan
 
     public:
         // Vulkan instance and core objects
-        VkInstance                 m_instance                          = VK_NULL_HANDLE;
-        VkDebugUtilsMessengerEXT   m_debugUtilsMessenger               = VK_NULL_HANDLE;
-        VkPhysicalDevice           m_physicalDevice                    = VK_NULL_HANDLE;
-        VkDevice                   m_device                            = VK_NULL_HANDLE;
-        VmaAllocator               m_deviceAllocator                   = VK_NULL_HANDLE;
-        IQueue                     m_queue[(uint32_t)QueueType::Count] = {};
-        BindGroupAllocator         m_bindGroupAllocator;
-        TL::Ptr<class DeleteQueue> m_destroyQueue = nullptr;
-        TL::Arena                  m_arena;
+        VkInstance                       m_instance                          = VK_NULL_HANDLE;
+        VkDebugUtilsMessengerEXT         m_debugUtilsMessenger               = VK_NULL_HANDLE;
+        VkPhysicalDevice                 m_physicalDevice                    = VK_NULL_HANDLE;
+        VkDevice                         m_device                            = VK_NULL_HANDLE;
+        VmaAllocator                     m_deviceAllocator                   = VK_NULL_HANDLE;
+        IQueue                           m_queue[(uint32_t)QueueType::Count] = {};
+        BindGroupAllocator               m_bindGroupAllocator;
+        BindlessHeap                     m_bindlessHeap;
+        BindGroupCache                   m_bindGroupCache;
+        TL::Ptr<class DeleteQueue>       m_destroyQueue = nullptr;
+        TL::Ptr<UploadEngine>            m_uploadEngine = nullptr;
+        // Backs AllocateDynamic, regions are retired with the graphics timeline in EndFrame.
+        StagingRing                      m_dynamicRing;
+        std::mutex                       m_dynamicRingMutex;
+        PipelineCache                    m_pipelineCache;
+        PipelineStateCache               m_pipelineStateCache;
+        PipelineCompiler                 m_pipelineCompiler;
+        PipelineManifest                 m_pipelineManifest;
+        ShaderModuleCache                m_shaderModuleCache;
+        // Kept alive until shutdown so Create calls matching a precompiled pipeline are cache hits.
+        TL::Vector<IGraphicsPipeline*>   m_precompiledGraphicsPipelines;
+        TL::Vector<IComputePipeline*>    m_precompiledComputePipelines;
+        TL::Vector<IRayTracingPipeline*> m_precompiledRayTracingPipelines;
+        TL::Arena                        m_arena;
+
+        // Descriptor sizes and alignments, only queried when DeviceFeatures::hasDescriptorBuffer is set.
+        VkPhysicalDeviceDescriptorBufferPropertiesEXT m_descriptorBufferProperties = {};
+
+        // Frames in flight
+        static constexpr uint32_t MaxFramesInFlight = 4;
+
+        IFrame                     m_frames[MaxFramesInFlight] = {};
+        uint32_t                   m_framesInFlight            = 2;
+        uint32_t                   m_frameIndex                = 0;
     };
 
     using VmaImageAllocation  = std::pair<VkImage, VmaAllocation>;
@@ -140,8 +269,8 @@ namespace RHI::Vulkan
     template<typename Resource>
     struct ResourceDeleteQueueEntry
     {
-        uint64_t timeline;
-        Resource resource;
+        QueueTimelineValues timeline;
+        Resource            resource;
     };
 
     class DeleteQueue
@@ -151,29 +280,33 @@ namespace RHI::Vulkan
 
         // clang-format off
         // simple handle pushes
-        void Push(uint64_t timeline, VmaAllocation h) { PushImpl(m_allocation, timeline, h); }
-        void Push(uint64_t timeline, VkBuffer h) { PushImpl(m_buffer, timeline, h); }
-        void Push(uint64_t timeline, VkBufferView h) { PushImpl(m_bufferView, timeline, h); }
-        void Push(uint64_t timeline, VkImage h) { PushImpl(m_image, timeline, h); }
-        void Push(uint64_t timeline, VkImageView h) { PushImpl(m_imageView, timeline, h); }
-        void Push(uint64_t timeline, VkSampler h) { PushImpl(m_sampler, timeline, h); }
-        void Push(uint64_t timeline, VkPipeline h) { PushImpl(m_pipeline, timeline, h); }
-        void Push(uint64_t timeline, VkDescriptorPool h) { PushImpl(m_descriptorPool, timeline, h); }
-        void Push(uint64_t timeline, VkQueryPool h) { PushImpl(m_queryPool, timeline, h); }
-        void Push(uint64_t timeline, VkSwapchainKHR h) { PushImpl(m_swapchain, timeline, h); }
-        void Push(uint64_t timeline, VkSurfaceKHR h) { PushImpl(m_surface, timeline, h); }
-        void Push(uint64_t timeline, VkSemaphore h) { PushImpl(m_semaphore, timeline, h); }
-        void Push(uint64_t timeline, VkAccelerationStructureKHR h) { PushImpl(m_accelerationStructure, timeline, h); }
-        void Push(uint64_t timeline, VkMicromapEXT h) { PushImpl(m_micromap, timeline, h); }
-        // void Push(uint64_t timeline, VmaBufferAllocation h) { PushImpl(, timeline, h.first);  PushImpl(m_vmaBuffer, timeline, h.second);}
-        // void Push(uint64_t timeline, VmaImageAllocation h) { PushImpl(m_vmaImage, timeline, h.first);  PushImpl(m_vmaImage, timeline, h.second);}
+        void Push(const QueueTimelineValues& timeline, VmaAllocation h) { PushImpl(m_allocation, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkBuffer h) { PushImpl(m_buffer, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkBufferView h) { PushImpl(m_bufferView, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkImage h) { PushImpl(m_image, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkImageView h) { PushImpl(m_imageView, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkSampler h) { PushImpl(m_sampler, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkPipeline h) { PushImpl(m_pipeline, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkDescriptorPool h) { PushImpl(m_descriptorPool, timeline, h); }
+        // Bind groups of the shared BindGroupAllocator, a set of its pool or a range of its descriptor buffer.
+        void Push(const QueueTimelineValues& timeline, VkDescriptorSet h) { PushImpl(m_descriptorSet, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VmaVirtualAllocation h) { PushImpl(m_descriptorRange, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkQueryPool h) { PushImpl(m_queryPool, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkSwapchainKHR h) { PushImpl(m_swapchain, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkSurfaceKHR h) { PushImpl(m_surface, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkSemaphore h) { PushImpl(m_semaphore, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkAccelerationStructureKHR h) { PushImpl(m_accelerationStructure, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkMicromapEXT h) { PushImpl(m_micromap, timeline, h); }
+        void Push(const QueueTimelineValues& timeline, VkShaderEXT h) { PushImpl(m_shader, timeline, h); }
+        // void Push(const QueueTimelineValues& timeline, VmaBufferAllocation h) { PushImpl(, timeline, h.first);  PushImpl(m_vmaBuffer, timeline, h.second);}
+        // void Push(const QueueTimelineValues& timeline, VmaImageAllocation h) { PushImpl(m_vmaImage, timeline, h.first);  PushImpl(m_vmaImage, timeline, h.second);}
         // clang-format on
 
-        void Flush(IDevice* device, uint64_t timeline);
+        void Flush(IDevice* device, const QueueTimelineValues& completed);
 
     private:
         template<typename ResourceType>
-        void FlushQueue(IDevice* device, TL::Vector<ResourceDeleteQueueEntry<ResourceType>>& queue, uint64_t timeline);
+        void FlushQueue(IDevice* device, TL::Vector<ResourceDeleteQueueEntry<ResourceType>>& queue, const QueueTimelineValues& completed);
 
         // Returns a unique uint64_t per ResourceType, collision-free across types.
         // Uses a static-local-variable address as a zero-cost type identity.
@@ -186,13 +319,14 @@ namespace RHI::Vulkan
 
         // Generic push implementation for single-handle resources
         template<typename ResourceType>
-        void PushImpl(TL::Vector<ResourceDeleteQueueEntry<ResourceType>>& queue, uint64_t timeline, ResourceType h)
+        void PushImpl(TL::Vector<ResourceDeleteQueueEntry<ResourceType>>& queue, const QueueTimelineValues& timeline, ResourceType h)
         {
             static_assert(sizeof(ResourceType) <= sizeof(uint64_t), "ResourceType must fit in a uint64_t key");
             uint64_t handleVal = 0;
             memcpy(&handleVal, &h, sizeof(h));
             uint64_t key = TL::HashCombine(typeKey<ResourceType>(), handleVal);
 
+            std::lock_guard lock(m_mutex);
             if (auto it = m_pending.find(key); it != m_pending.end())
             {
                 auto st = TL::ReportStacktrace(it->second);
@@ -216,13 +350,18 @@ namespace RHI::Vulkan
         TL::Vector<ResourceDeleteQueueEntry<VkSampler>>                  m_sampler;
         TL::Vector<ResourceDeleteQueueEntry<VkPipeline>>                 m_pipeline;
         TL::Vector<ResourceDeleteQueueEntry<VkDescriptorPool>>           m_descriptorPool;
+        TL::Vector<ResourceDeleteQueueEntry<VkDescriptorSet>>            m_descriptorSet;
+        TL::Vector<ResourceDeleteQueueEntry<VmaVirtualAllocation>>       m_descriptorRange;
         TL::Vector<ResourceDeleteQueueEntry<VkQueryPool>>                m_queryPool;
         TL::Vector<ResourceDeleteQueueEntry<VkSwapchainKHR>>             m_swapchain;
         TL::Vector<ResourceDeleteQueueEntry<VkSurfaceKHR>>               m_surface;
         TL::Vector<ResourceDeleteQueueEntry<VkSemaphore>>                m_semaphore;
         TL::Vector<ResourceDeleteQueueEntry<VkAccelerationStructureKHR>> m_accelerationStructure;
         TL::Vector<ResourceDeleteQueueEntry<VkMicromapEXT>>              m_micromap;
+        TL::Vector<ResourceDeleteQueueEntry<VkShaderEXT>>                m_shader;
         TL::Map<uint64_t, TL::Stacktrace>                                m_pending;
+        // Resources are also released from pipeline compiler workers.
+        std::mutex                                                       m_mutex;
     };
 
 } // namespace RHI::Vulkan
\ No newline at end of file
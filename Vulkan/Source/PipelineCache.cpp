@@ -0,0 +1,945 @@
+#include "PipelineCache.hpp"
+#include "Common.hpp"
+#include "Device.hpp"
+
+#include <TL/Log.hpp>
+#include <TL/Utils.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#include <tracy/Tracy.hpp>
+
+namespace RHI::Vulkan
+{
+    inline static TL::Vector<uint8_t> ReadFile(const TL::String& path)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+        if (!file)
+            return {};
+
+        TL::Vector<uint8_t> data(size_t(file.tellg()));
+        file.seekg(0);
+        if (!file.read((char*)data.data(), data.size()))
+            return {};
+        return data;
+    }
+
+    // Writes to a temporary file then renames it over the previous one, a crash never leaves a torn file.
+    inline static ResultCode WriteFile(const TL::String& path, TL::Span<const uint8_t> data)
+    {
+        auto tempPath = TL::fmt("{}.tmp", path);
+        {
+            std::ofstream file(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+            if (!file || !file.write((const char*)data.data(), data.size()) || !file.flush())
+            {
+                TL::LogError("Failed to write {}", tempPath);
+                return ResultCode::ErrorUnknown;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath.c_str(), path.c_str(), error);
+        if (error)
+        {
+            TL::LogError("Failed to replace {}: {}", path, error.message());
+            std::filesystem::remove(tempPath.c_str(), error);
+            return ResultCode::ErrorUnknown;
+        }
+        return ResultCode::Success;
+    }
+
+    ResultCode PipelineCache::Init(IDevice* device, const char* path)
+    {
+        ZoneScoped;
+
+        auto start = std::chrono::steady_clock::now();
+
+        m_path = path ? path : "";
+
+        TL::Vector<uint8_t> data;
+        if (!m_path.empty())
+        {
+            data = ReadFile(m_path);
+            if (!data.empty() && !IsCompatible(device, data))
+            {
+                TL::LogWarn("Pipeline cache {} was created by a different device or driver, discarding it", m_path);
+                data.clear();
+            }
+        }
+        m_warm = !data.empty();
+
+        VkPipelineCacheCreateInfo pipelineCacheCI{
+            .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .pNext           = nullptr,
+            .flags           = 0,
+            .initialDataSize = data.size(),
+            .pInitialData    = data.data(),
+        };
+        VulkanResult result = vkCreatePipelineCache(device->m_device, &pipelineCacheCI, nullptr, &m_handle);
+        if (!result && m_warm)
+        {
+            // The header matched but the driver still rejected the payload, start from an empty cache.
+            TL::LogWarn("Pipeline cache {} is corrupted, discarding it", m_path);
+            m_warm                          = false;
+            pipelineCacheCI.initialDataSize = 0;
+            pipelineCacheCI.pInitialData    = nullptr;
+            result                          = vkCreatePipelineCache(device->m_device, &pipelineCacheCI, nullptr, &m_handle);
+        }
+        if (!result)
+            return result;
+
+        device->SetDebugName(m_handle, "Pipeline cache");
+
+        auto loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (m_warm)
+            TL::LogInfo("Pipeline cache: loaded {} bytes from {} in {:.2f} ms (warm start)", data.size(), m_path, loadTime);
+        else
+            TL::LogInfo("Pipeline cache: starting empty (cold start)");
+        return ResultCode::Success;
+    }
+
+    void PipelineCache::Shutdown(IDevice* device)
+    {
+        if (m_handle == VK_NULL_HANDLE)
+            return;
+
+        if (uint32_t count = m_creationCount.load(); count != 0)
+        {
+            double totalMs = double(m_creationTimeNs.load()) / 1e6;
+            TL::LogInfo("Pipeline cache ({} start): created {} pipelines, {} of them cache hits, in {:.2f} ms, {:.3f} ms on average", m_warm ? "warm" : "cold", count, m_cacheHitCount.load(), totalMs, totalMs / count);
+        }
+
+        if (!m_path.empty())
+            (void)Save(device);
+
+        vkDestroyPipelineCache(device->m_device, m_handle, nullptr);
+        m_handle = VK_NULL_HANDLE;
+    }
+
+    ResultCode PipelineCache::Save(IDevice* device)
+    {
+        ZoneScoped;
+
+        if (m_path.empty())
+            return ResultCode::ErrorInvalidArguments;
+
+        std::lock_guard lock(m_saveMutex);
+
+        size_t       size   = 0;
+        VulkanResult result = vkGetPipelineCacheData(device->m_device, m_handle, &size, nullptr);
+        if (!result)
+            return result;
+
+        TL::Vector<uint8_t> data(size);
+        result = vkGetPipelineCacheData(device->m_device, m_handle, &size, data.data());
+        if (!result)
+            return result;
+
+        return WriteFile(m_path, TL::Span<const uint8_t>(data.data(), size));
+    }
+
+    void PipelineCache::AddCreationStats(const TL::String& name, std::chrono::steady_clock::duration duration, const VkPipelineCreationFeedback& feedback)
+    {
+        uint64_t durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        if (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT)
+            durationNs = feedback.duration;
+        bool cacheHit = feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT;
+
+        m_creationCount.fetch_add(1, std::memory_order_relaxed);
+        m_creationTimeNs.fetch_add(durationNs, std::memory_order_relaxed);
+        if (cacheHit)
+            m_cacheHitCount.fetch_add(1, std::memory_order_relaxed);
+
+        std::lock_guard lock(m_statsMutex);
+        m_records.push_back({name, durationNs, cacheHit});
+    }
+
+    uint32_t PipelineCache::GetStats(TL::Span<PipelineStats> stats)
+    {
+        std::lock_guard lock(m_statsMutex);
+
+        TL::Vector<const CreationRecord*> records;
+        records.reserve(m_records.size());
+        for (const auto& record : m_records)
+            records.push_back(&record);
+
+        size_t count = std::min(stats.size(), records.size());
+        std::partial_sort(records.begin(), records.begin() + count, records.end(), [](const CreationRecord* a, const CreationRecord* b)
+            {
+                return a->durationNs > b->durationNs;
+            });
+        for (size_t i = 0; i < count; ++i)
+        {
+            stats[i] = {
+                .name       = records[i]->name.c_str(),
+                .durationNs = records[i]->durationNs,
+                .cacheHit   = records[i]->cacheHit,
+            };
+        }
+        return uint32_t(m_records.size());
+    }
+
+    bool PipelineCache::IsCompatible(IDevice* device, const TL::Vector<uint8_t>& data)
+    {
+        VkPipelineCacheHeaderVersionOne header;
+        if (data.size() < sizeof(header))
+            return false;
+        memcpy(&header, data.data(), sizeof(header));
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device->m_physicalDevice, &properties);
+
+        // pipelineCacheUUID changes with the driver version, so this also rejects caches from older drivers.
+        return header.headerSize >= sizeof(header) &&
+               header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+               header.vendorID == properties.vendorID &&
+               header.deviceID == properties.deviceID &&
+               memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // PipelineStateCache
+    ////////////////////////////////////////////////////////////////////////
+
+    // Hashes values field by field, hashing whole structs would include their padding.
+    struct PipelineHasher
+    {
+        uint64_t hash;
+
+        template<typename T>
+        void Add(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(uint64_t));
+            uint64_t bits = 0;
+            memcpy(&bits, &value, sizeof(T));
+            hash = TL::HashCombine(hash, bits);
+        }
+
+        void Add(const char* string)
+        {
+            hash = TL::HashCombine(hash, std::hash<std::string_view>{}(string ? string : ""));
+        }
+
+        // Layouts are kept by the pipeline, so they are keyed by identity. Their addresses are not used since a
+        // layout created after one was destroyed may reuse it.
+        void Add(PipelineLayout* layout)
+        {
+            Add(layout ? ((IPipelineLayout*)layout)->uniqueId : uint64_t(0));
+        }
+
+        void Add(TL::Span<const PipelineShaderStage> stages)
+        {
+            Add(stages.size());
+            for (const auto& stage : stages)
+            {
+                Add(stage.name);
+                // Modules are only needed while compiling, any module with the same code yields the same pipeline.
+                Add(stage.module ? ((IShaderModule*)stage.module)->m_contentHash : uint64_t(0));
+                Add(stage.stage);
+                Add(stage.specializationConstants.size());
+                for (const auto& constant : stage.specializationConstants)
+                {
+                    Add(constant.id);
+                    Add(constant.size);
+                    Add(constant.value);
+                }
+            }
+        }
+    };
+
+    // Distinct seeds keep pipelines of different kinds apart in the shared map.
+    enum class PipelineKind : uint64_t
+    {
+        Graphics = 1,
+        Compute,
+        RayTracing,
+        Linked,
+    };
+
+    uint64_t PipelineStateCache::Hash(const GraphicsPipelineCreateInfo& createInfo)
+    {
+        PipelineHasher hasher{(uint64_t)PipelineKind::Graphics};
+        hasher.Add(createInfo.shaderStages);
+        hasher.Add(createInfo.layout);
+
+        hasher.Add(createInfo.vertexBufferBindings.size());
+        for (const auto& binding : createInfo.vertexBufferBindings)
+        {
+            hasher.Add(binding.stride);
+            hasher.Add(binding.stepRate);
+            hasher.Add(binding.attributes.size());
+            for (const auto& attribute : binding.attributes)
+            {
+                hasher.Add(attribute.offset);
+                hasher.Add(attribute.format);
+            }
+        }
+
+        hasher.Add(createInfo.renderTargetLayout.colors.size());
+        for (auto format : createInfo.renderTargetLayout.colors)
+            hasher.Add(format);
+        hasher.Add(createInfo.renderTargetLayout.depth);
+        hasher.Add(createInfo.renderTargetLayout.stencil);
+
+        hasher.Add(createInfo.colorBlendState.blendStates.size());
+        for (const auto& blendState : createInfo.colorBlendState.blendStates)
+        {
+            hasher.Add(blendState.blendEnable);
+            hasher.Add(blendState.colorBlendOp);
+            hasher.Add(blendState.srcColor);
+            hasher.Add(blendState.dstColor);
+            hasher.Add(blendState.alphaBlendOp);
+            hasher.Add(blendState.srcAlpha);
+            hasher.Add(blendState.dstAlpha);
+            hasher.Add(blendState.writeMask);
+        }
+        for (float blendConstant : createInfo.colorBlendState.blendConstants)
+            hasher.Add(blendConstant);
+
+        hasher.Add(createInfo.topologyMode);
+        hasher.Add(createInfo.rasterizationState.fillMode);
+        hasher.Add(createInfo.rasterizationState.lineWidth);
+        hasher.Add(createInfo.multisampleState.sampleCount);
+        hasher.Add(createInfo.multisampleState.sampleShading);
+
+        // Still part of the key with dynamicState, binding the pipeline applies them before any Set* override.
+        hasher.Add(createInfo.dynamicState);
+        hasher.Add(createInfo.rasterizationState.cullMode);
+        hasher.Add(createInfo.rasterizationState.frontFace);
+        hasher.Add(createInfo.depthStencilState.depthTestEnable);
+        hasher.Add(createInfo.depthStencilState.depthWriteEnable);
+        hasher.Add(createInfo.depthStencilState.compareOperator);
+        hasher.Add(createInfo.depthStencilState.stencilTestEnable);
+        return hasher.hash;
+    }
+
+    uint64_t PipelineStateCache::Hash(const ComputePipelineCreateInfo& createInfo)
+    {
+        PipelineHasher hasher{(uint64_t)PipelineKind::Compute};
+        hasher.Add(TL::Span<const PipelineShaderStage>(&createInfo.computeShader, 1));
+        hasher.Add(createInfo.layout);
+        return hasher.hash;
+    }
+
+    uint64_t PipelineStateCache::Hash(const RayTracingPipelineCreateInfo& createInfo)
+    {
+        PipelineHasher hasher{(uint64_t)PipelineKind::RayTracing};
+        hasher.Add(createInfo.shaderStages);
+        hasher.Add(createInfo.layout);
+        hasher.Add(createInfo.shaderGroups.size());
+        for (const auto& group : createInfo.shaderGroups)
+        {
+            hasher.Add(group.type);
+            hasher.Add(group.generalShader);
+            hasher.Add(group.closestHitShader);
+            hasher.Add(group.anyHitShader);
+            hasher.Add(group.intersectionShader);
+        }
+        hasher.Add(createInfo.maxRecursionDepth);
+        return hasher.hash;
+    }
+
+    uint64_t PipelineStateCache::Hash(const GraphicsPipelineLinkInfo& linkInfo)
+    {
+        PipelineHasher hasher{(uint64_t)PipelineKind::Linked};
+        hasher.Add(linkInfo.libraries.size());
+        for (auto library : linkInfo.libraries)
+            hasher.Add(((IGraphicsPipelineLibrary*)library)->uniqueId);
+        hasher.Add(linkInfo.layout);
+        hasher.Add(linkInfo.optimize);
+        return hasher.hash;
+    }
+
+    bool PipelineStateCache::Release(const ResourceBase* pipeline, uint64_t key)
+    {
+        // Under the lock, so a concurrent FindOrInsert can not revive a pipeline whose last reference is gone.
+        std::lock_guard lock(m_mutex);
+        if (!pipeline->release())
+            return false;
+        // A failed pipeline was removed already, and its key may be owned by a newer one.
+        if (auto it = m_pipelines.find(key); it != m_pipelines.end() && it->second == pipeline)
+            m_pipelines.erase(it);
+        return true;
+    }
+
+    void PipelineStateCache::Remove(const ResourceBase* pipeline, uint64_t key)
+    {
+        std::lock_guard lock(m_mutex);
+        if (auto it = m_pipelines.find(key); it != m_pipelines.end() && it->second == pipeline)
+            m_pipelines.erase(it);
+    }
+
+    PipelineCacheStats PipelineStateCache::GetStats()
+    {
+        std::lock_guard lock(m_mutex);
+        return {
+            .hitCount      = m_hitCount,
+            .missCount     = m_missCount,
+            .pipelineCount = uint32_t(m_pipelines.size()),
+        };
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // ShaderModuleCache
+    ////////////////////////////////////////////////////////////////////////
+
+    // Consumes 8 bytes per step with a multiply and xor-shift mix. Unlike std::hash the result is stable across runs,
+    // the pipeline manifest stores it.
+    inline static uint64_t HashBytes(const void* data, size_t size)
+    {
+        constexpr uint64_t Multiplier = 0x9e3779b97f4a7c15;
+
+        auto     bytes = (const uint8_t*)data;
+        uint64_t hash  = 0xcbf29ce484222325 ^ (size * Multiplier);
+        for (; size >= sizeof(uint64_t); bytes += sizeof(uint64_t), size -= sizeof(uint64_t))
+        {
+            uint64_t word;
+            memcpy(&word, bytes, sizeof(uint64_t));
+            hash = (hash ^ word) * Multiplier;
+            hash ^= hash >> 32;
+        }
+
+        uint64_t tail = 0;
+        if (size != 0)
+            memcpy(&tail, bytes, size);
+        hash = (hash ^ tail) * Multiplier;
+        return hash ^ (hash >> 29);
+    }
+
+    uint64_t ShaderModuleCache::Hash(TL::Span<const uint32_t> code)
+    {
+        return HashBytes(code.data(), code.size_bytes());
+    }
+
+    IShaderModule* ShaderModuleCache::Find(uint64_t key)
+    {
+        std::lock_guard lock(m_mutex);
+        auto            it = m_shaderModules.find(key);
+        if (it == m_shaderModules.end())
+            return nullptr;
+        it->second->addRef();
+        return it->second;
+    }
+
+    IShaderModule* ShaderModuleCache::Insert(uint64_t key, IShaderModule* shaderModule)
+    {
+        std::lock_guard lock(m_mutex);
+        if (auto it = m_shaderModules.find(key); it != m_shaderModules.end())
+        {
+            it->second->addRef();
+            return it->second;
+        }
+        shaderModule->m_contentHash = key;
+        m_shaderModules[key]        = shaderModule;
+        return shaderModule;
+    }
+
+    IShaderModule* ShaderModuleCache::Get(uint64_t key)
+    {
+        std::lock_guard lock(m_mutex);
+        auto            it = m_shaderModules.find(key);
+        return it != m_shaderModules.end() ? it->second : nullptr;
+    }
+
+    bool ShaderModuleCache::Release(IShaderModule* shaderModule)
+    {
+        // Under the lock, so a concurrent Find can not revive a module whose last reference is gone.
+        std::lock_guard lock(m_mutex);
+        if (!shaderModule->release())
+            return false;
+        m_shaderModules.erase(shaderModule->m_contentHash);
+        return true;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // PipelineManifest
+    ////////////////////////////////////////////////////////////////////////
+
+    constexpr uint32_t ManifestMagic   = 0x4D504852; // "RHPM"
+    constexpr uint32_t ManifestVersion = 2;
+
+    struct ManifestWriter
+    {
+        TL::Vector<uint8_t>& data;
+
+        template<typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            size_t offset = data.size();
+            data.resize(offset + sizeof(T));
+            memcpy(data.data() + offset, &value, sizeof(T));
+        }
+
+        void Write(const char* string)
+        {
+            std::string_view view = string ? string : "";
+            Write(uint32_t(view.size()));
+            data.insert(data.end(), view.begin(), view.end());
+        }
+
+        void Write(PipelineLayout* layout)
+        {
+            Write(layout ? ((IPipelineLayout*)layout)->contentHash : uint64_t(0));
+        }
+
+        void Write(TL::Span<const PipelineShaderStage> stages)
+        {
+            Write(uint32_t(stages.size()));
+            for (const auto& stage : stages)
+            {
+                Write(((IShaderModule*)stage.module)->m_contentHash);
+                Write(stage.name);
+                Write(stage.stage);
+                Write(uint32_t(stage.specializationConstants.size()));
+                for (const auto& constant : stage.specializationConstants)
+                {
+                    Write(constant.id);
+                    Write(constant.size);
+                    Write(constant.value);
+                }
+            }
+        }
+    };
+
+    struct ManifestReader
+    {
+        TL::Span<const uint8_t> data;
+        size_t                  offset = 0;
+        bool                    valid  = true;
+
+        template<typename T>
+        T Read()
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T value{};
+            if (data.size() - offset < sizeof(T))
+            {
+                valid = false;
+                return value;
+            }
+            memcpy(&value, data.data() + offset, sizeof(T));
+            offset += sizeof(T);
+            return value;
+        }
+
+        template<typename T>
+        void Read(T& value)
+        {
+            value = Read<T>();
+        }
+
+        // Every element takes at least a byte, so a corrupted count never turns into a huge allocation.
+        uint32_t ReadCount()
+        {
+            auto count = Read<uint32_t>();
+            if (count > data.size() - offset)
+            {
+                valid = false;
+                return 0;
+            }
+            return count;
+        }
+
+        TL::String ReadString()
+        {
+            uint32_t   size = ReadCount();
+            TL::String string((const char*)data.data() + offset, size);
+            offset += size;
+            return string;
+        }
+    };
+
+    // Calls fn(kind, payload) for every entry of a serialized manifest, returns false when it is malformed.
+    template<typename Fn>
+    inline static bool ForEachManifestEntry(TL::Span<const uint8_t> data, Fn&& fn)
+    {
+        ManifestReader reader{data};
+        auto           magic      = reader.Read<uint32_t>();
+        auto           version    = reader.Read<uint32_t>();
+        auto           entryCount = reader.Read<uint32_t>();
+        if (!reader.valid || magic != ManifestMagic || version != ManifestVersion)
+            return false;
+
+        for (uint32_t i = 0; i < entryCount; ++i)
+        {
+            auto kind = reader.Read<uint32_t>();
+            auto size = reader.ReadCount();
+            if (!reader.valid || !fn(kind, TL::Span<const uint8_t>(data.data() + reader.offset, size)))
+                return false;
+            reader.offset += size;
+        }
+        return reader.offset == data.size();
+    }
+
+    uint64_t PipelineManifest::Hash(const PipelineLayoutCreateInfo& createInfo)
+    {
+        PipelineHasher hasher{0};
+        hasher.Add(createInfo.layouts.size());
+        for (auto layout : createInfo.layouts)
+        {
+            auto bindGroupLayout = (IBindGroupLayout*)layout;
+            hasher.Add(bindGroupLayout->shaderBindings.size());
+            for (const auto& binding : bindGroupLayout->shaderBindings)
+            {
+                hasher.Add(binding.type);
+                hasher.Add(binding.access);
+                hasher.Add(binding.arrayCount);
+                hasher.Add(binding.stages);
+                hasher.Add(binding.bufferStride);
+            }
+        }
+        hasher.Add(createInfo.pushConstants.size());
+        for (const auto& range : createInfo.pushConstants)
+        {
+            hasher.Add(range.stages);
+            hasher.Add(range.offset);
+            hasher.Add(range.size);
+        }
+        return hasher.hash;
+    }
+
+    void PipelineManifest::Init(const char* path)
+    {
+        ZoneScoped;
+
+        m_path = path ? path : "";
+        if (m_path.empty())
+            return;
+
+        auto data  = ReadFile(m_path);
+        bool valid = ForEachManifestEntry(data, [this](uint32_t kind, TL::Span<const uint8_t> payload)
+            {
+                Append(kind, payload);
+                return true;
+            });
+        if (!valid)
+        {
+            if (!data.empty())
+                TL::LogWarn("Pipeline manifest {} is corrupted or outdated, discarding it", m_path);
+            m_entries.clear();
+            m_recorded.clear();
+            m_entryCount = 0;
+            return;
+        }
+        TL::LogInfo("Pipeline manifest: loaded {} pipelines from {}", m_entryCount, m_path);
+    }
+
+    void PipelineManifest::Shutdown()
+    {
+        if (!m_path.empty())
+            (void)Save();
+    }
+
+    ResultCode PipelineManifest::Save()
+    {
+        ZoneScoped;
+
+        if (m_path.empty())
+            return ResultCode::ErrorInvalidArguments;
+
+        TL::Vector<uint8_t> data;
+        {
+            std::lock_guard lock(m_mutex);
+            data = Serialize();
+        }
+        return WriteFile(m_path, data);
+    }
+
+    void PipelineManifest::AddPipelineLayout(IPipelineLayout* layout)
+    {
+        std::lock_guard lock(m_mutex);
+        m_pipelineLayouts[layout->contentHash] = layout;
+    }
+
+    void PipelineManifest::RemovePipelineLayout(IPipelineLayout* layout)
+    {
+        std::lock_guard lock(m_mutex);
+        if (auto it = m_pipelineLayouts.find(layout->contentHash); it != m_pipelineLayouts.end() && it->second == layout)
+            m_pipelineLayouts.erase(it);
+    }
+
+    void PipelineManifest::Record(const GraphicsPipelineCreateInfo& createInfo)
+    {
+        if (m_path.empty())
+            return;
+
+        TL::Vector<uint8_t> payload;
+        ManifestWriter      writer{payload};
+        writer.Write(createInfo.shaderStages);
+        writer.Write(createInfo.layout);
+
+        writer.Write(uint32_t(createInfo.vertexBufferBindings.size()));
+        for (const auto& binding : createInfo.vertexBufferBindings)
+        {
+            writer.Write(binding.stride);
+            writer.Write(binding.stepRate);
+            writer.Write(uint32_t(binding.attributes.size()));
+            for (const auto& attribute : binding.attributes)
+            {
+                writer.Write(attribute.offset);
+                writer.Write(attribute.format);
+            }
+        }
+
+        writer.Write(uint32_t(createInfo.renderTargetLayout.colors.size()));
+        for (auto format : createInfo.renderTargetLayout.colors)
+            writer.Write(format);
+        writer.Write(createInfo.renderTargetLayout.depth);
+        writer.Write(createInfo.renderTargetLayout.stencil);
+
+        writer.Write(uint32_t(createInfo.colorBlendState.blendStates.size()));
+        for (const auto& blendState : createInfo.colorBlendState.blendStates)
+        {
+            writer.Write(blendState.blendEnable);
+            writer.Write(blendState.colorBlendOp);
+            writer.Write(blendState.srcColor);
+            writer.Write(blendState.dstColor);
+            writer.Write(blendState.alphaBlendOp);
+            writer.Write(blendState.srcAlpha);
+            writer.Write(blendState.dstAlpha);
+            writer.Write(blendState.writeMask);
+        }
+        for (float blendConstant : createInfo.colorBlendState.blendConstants)
+            writer.Write(blendConstant);
+
+        writer.Write(createInfo.topologyMode);
+        writer.Write(createInfo.rasterizationState.cullMode);
+        writer.Write(createInfo.rasterizationState.fillMode);
+        writer.Write(createInfo.rasterizationState.frontFace);
+        writer.Write(createInfo.rasterizationState.lineWidth);
+        writer.Write(createInfo.multisampleState.sampleCount);
+        writer.Write(createInfo.multisampleState.sampleShading);
+        writer.Write(createInfo.depthStencilState.depthTestEnable);
+        writer.Write(createInfo.depthStencilState.depthWriteEnable);
+        writer.Write(createInfo.depthStencilState.compareOperator);
+        writer.Write(createInfo.depthStencilState.stencilTestEnable);
+        writer.Write(createInfo.dynamicState);
+        Append((uint32_t)PipelineKind::Graphics, payload);
+    }
+
+    void PipelineManifest::Record(const ComputePipelineCreateInfo& createInfo)
+    {
+        if (m_path.empty())
+            return;
+
+        TL::Vector<uint8_t> payload;
+        ManifestWriter      writer{payload};
+        writer.Write(TL::Span<const PipelineShaderStage>(&createInfo.computeShader, 1));
+        writer.Write(createInfo.layout);
+        Append((uint32_t)PipelineKind::Compute, payload);
+    }
+
+    void PipelineManifest::Record(const RayTracingPipelineCreateInfo& createInfo)
+    {
+        if (m_path.empty())
+            return;
+
+        TL::Vector<uint8_t> payload;
+        ManifestWriter      writer{payload};
+        writer.Write(createInfo.shaderStages);
+        writer.Write(createInfo.layout);
+        writer.Write(uint32_t(createInfo.shaderGroups.size()));
+        for (const auto& group : createInfo.shaderGroups)
+        {
+            writer.Write(group.type);
+            writer.Write(group.generalShader);
+            writer.Write(group.closestHitShader);
+            writer.Write(group.anyHitShader);
+            writer.Write(group.intersectionShader);
+        }
+        writer.Write(createInfo.maxRecursionDepth);
+        Append((uint32_t)PipelineKind::RayTracing, payload);
+    }
+
+    ResultCode PipelineManifest::Load(const char* path, ShaderModuleCache& shaderModules, Entries& entries)
+    {
+        ZoneScoped;
+
+        TL::Vector<uint8_t> data;
+        if (path)
+        {
+            data = ReadFile(path);
+            if (data.empty())
+            {
+                TL::LogError("Failed to read pipeline manifest {}", path);
+                return ResultCode::ErrorUnknown;
+            }
+        }
+
+        std::lock_guard lock(m_mutex);
+        if (!path)
+            data = Serialize();
+        if (!Parse(data, shaderModules, entries))
+        {
+            TL::LogError("Pipeline manifest {} is corrupted or outdated", path ? path : m_path.c_str());
+            return ResultCode::ErrorUnknown;
+        }
+        return ResultCode::Success;
+    }
+
+    void PipelineManifest::Append(uint32_t kind, TL::Span<const uint8_t> payload)
+    {
+        uint64_t hash = TL::HashCombine(HashBytes(payload.data(), payload.size()), kind);
+
+        std::lock_guard lock(m_mutex);
+        if (m_recorded.find(hash) != m_recorded.end())
+            return;
+        m_recorded[hash] = m_entryCount++;
+
+        ManifestWriter writer{m_entries};
+        writer.Write(kind);
+        writer.Write(uint32_t(payload.size()));
+        m_entries.insert(m_entries.end(), payload.begin(), payload.end());
+    }
+
+    TL::Vector<uint8_t> PipelineManifest::Serialize() const
+    {
+        TL::Vector<uint8_t> data;
+        ManifestWriter      writer{data};
+        writer.Write(ManifestMagic);
+        writer.Write(ManifestVersion);
+        writer.Write(m_entryCount);
+        data.insert(data.end(), m_entries.begin(), m_entries.end());
+        return data;
+    }
+
+    bool PipelineManifest::Parse(TL::Span<const uint8_t> data, ShaderModuleCache& shaderModules, Entries& entries)
+    {
+        return ForEachManifestEntry(data, [&](uint32_t kind, TL::Span<const uint8_t> payload)
+            {
+                ManifestReader reader{payload};
+                bool           resolved = true;
+
+                auto readStages = [&](ShaderStagesDesc& desc)
+                {
+                    for (uint32_t i = 0, count = reader.ReadCount(); i < count; ++i)
+                    {
+                        PipelineShaderStage stage{};
+                        stage.module = shaderModules.Get(reader.Read<uint64_t>());
+                        resolved &= stage.module != nullptr;
+                        desc.entryPoints.push_back(reader.ReadString());
+                        reader.Read(stage.stage);
+                        desc.stages.push_back(stage);
+
+                        auto& constants = desc.specializationConstants.emplace_back();
+                        for (uint32_t j = 0, constantCount = reader.ReadCount(); j < constantCount; ++j)
+                        {
+                            auto& constant = constants.emplace_back();
+                            reader.Read(constant.id);
+                            reader.Read(constant.size);
+                            reader.Read(constant.value);
+                        }
+                    }
+                };
+
+                auto readLayout = [&]() -> PipelineLayout*
+                {
+                    auto hash = reader.Read<uint64_t>();
+                    if (hash == 0)
+                        return nullptr;
+                    auto layout = m_pipelineLayouts.find(hash);
+                    resolved &= layout != m_pipelineLayouts.end();
+                    return layout != m_pipelineLayouts.end() ? layout->second : nullptr;
+                };
+
+                switch ((PipelineKind)kind)
+                {
+                case PipelineKind::Graphics:
+                {
+                    GraphicsPipelineDesc desc{GraphicsPipelineCreateInfo{}};
+                    auto&                createInfo = desc.createInfo;
+                    readStages(desc.shaderStages);
+                    createInfo.layout = readLayout();
+
+                    for (uint32_t i = 0, count = reader.ReadCount(); i < count; ++i)
+                    {
+                        auto& binding = desc.vertexBindings.emplace_back();
+                        reader.Read(binding.stride);
+                        reader.Read(binding.stepRate);
+                        auto& attributes = desc.vertexAttributes.emplace_back();
+                        for (uint32_t j = 0, attributeCount = reader.ReadCount(); j < attributeCount; ++j)
+                        {
+                            auto& attribute = attributes.emplace_back();
+                            reader.Read(attribute.offset);
+                            reader.Read(attribute.format);
+                        }
+                    }
+
+                    for (uint32_t i = 0, count = reader.ReadCount(); i < count; ++i)
+                        desc.colorFormats.push_back(reader.Read<Format>());
+                    reader.Read(createInfo.renderTargetLayout.depth);
+                    reader.Read(createInfo.renderTargetLayout.stencil);
+
+                    for (uint32_t i = 0, count = reader.ReadCount(); i < count; ++i)
+                    {
+                        auto& blendState = desc.blendStates.emplace_back();
+                        reader.Read(blendState.blendEnable);
+                        reader.Read(blendState.colorBlendOp);
+                        reader.Read(blendState.srcColor);
+                        reader.Read(blendState.dstColor);
+                        reader.Read(blendState.alphaBlendOp);
+                        reader.Read(blendState.srcAlpha);
+                        reader.Read(blendState.dstAlpha);
+                        reader.Read(blendState.writeMask);
+                    }
+                    for (float& blendConstant : createInfo.colorBlendState.blendConstants)
+                        reader.Read(blendConstant);
+
+                    reader.Read(createInfo.topologyMode);
+                    reader.Read(createInfo.rasterizationState.cullMode);
+                    reader.Read(createInfo.rasterizationState.fillMode);
+                    reader.Read(createInfo.rasterizationState.frontFace);
+                    reader.Read(createInfo.rasterizationState.lineWidth);
+                    reader.Read(createInfo.multisampleState.sampleCount);
+                    reader.Read(createInfo.multisampleState.sampleShading);
+                    reader.Read(createInfo.depthStencilState.depthTestEnable);
+                    reader.Read(createInfo.depthStencilState.depthWriteEnable);
+                    reader.Read(createInfo.depthStencilState.compareOperator);
+                    reader.Read(createInfo.depthStencilState.stencilTestEnable);
+                    reader.Read(createInfo.dynamicState);
+                    if (resolved)
+                        entries.graphics.push_back(std::move(desc));
+                    break;
+                }
+                case PipelineKind::Compute:
+                {
+                    ComputePipelineDesc desc{ComputePipelineCreateInfo{}};
+                    readStages(desc.computeShader);
+                    desc.createInfo.layout = readLayout();
+                    if (resolved)
+                        entries.compute.push_back(std::move(desc));
+                    break;
+                }
+                case PipelineKind::RayTracing:
+                {
+                    RayTracingPipelineDesc desc{RayTracingPipelineCreateInfo{}};
+                    readStages(desc.shaderStages);
+                    desc.createInfo.layout = readLayout();
+                    for (uint32_t i = 0, count = reader.ReadCount(); i < count; ++i)
+                    {
+                        auto& group = desc.shaderGroups.emplace_back();
+                        reader.Read(group.type);
+                        reader.Read(group.generalShader);
+                        reader.Read(group.closestHitShader);
+                        reader.Read(group.anyHitShader);
+                        reader.Read(group.intersectionShader);
+                    }
+                    reader.Read(desc.createInfo.maxRecursionDepth);
+                    if (resolved)
+                        entries.rayTracing.push_back(std::move(desc));
+                    break;
+                }
+                default: return false;
+                }
+
+                if (!resolved)
+                    entries.unresolvedCount++;
+                return reader.valid && reader.offset == payload.size();
+            });
+    }
+} // namespace RHI::Vulkan
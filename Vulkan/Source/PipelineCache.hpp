@@ -0,0 +1,183 @@
+#pragma once
+
+#include <RHI/RHI.h>
+
+#include "PipelineCompiler.hpp"
+
+#include <TL/Allocator/Allocator.hpp>
+#include <TL/Containers/Map.hpp>
+#include <TL/Containers/String.hpp>
+#include <TL/Containers/Vector.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+#include <volk.h>
+
+namespace RHI::Vulkan
+{
+    class IDevice;
+    struct IShaderModule;
+    struct IPipelineLayout;
+
+    // Device wide VkPipelineCache, seeded from and written back to a file on disk.
+    class PipelineCache
+    {
+    public:
+        ResultCode      Init(IDevice* device, const char* path);
+        void            Shutdown(IDevice* device);
+
+        // Writes the cache to a temporary file then renames it over the previous one, a crash never leaves a torn cache.
+        ResultCode      Save(IDevice* device);
+
+        VkPipelineCache GetHandle() const { return m_handle; }
+
+        // Records one vkCreate*Pipelines call. Totals are reported on shutdown to compare cold and warm runs, the
+        // per pipeline records back GetStats. The driver's feedback is preferred over the measured duration.
+        void            AddCreationStats(const TL::String& name, std::chrono::steady_clock::duration duration, const VkPipelineCreationFeedback& feedback);
+
+        uint32_t        GetStats(TL::Span<PipelineStats> stats);
+
+    private:
+        static bool IsCompatible(IDevice* device, const TL::Vector<uint8_t>& data);
+
+        struct CreationRecord
+        {
+            TL::String name;
+            uint64_t   durationNs;
+            bool       cacheHit;
+        };
+
+        VkPipelineCache            m_handle         = VK_NULL_HANDLE;
+        TL::String                 m_path;
+        // True when the cache was seeded with valid data from disk.
+        bool                       m_warm           = false;
+        std::mutex                 m_saveMutex;
+        std::atomic_uint32_t       m_creationCount  = 0;
+        std::atomic_uint32_t       m_cacheHitCount  = 0;
+        std::atomic_uint64_t       m_creationTimeNs = 0;
+        std::mutex                 m_statsMutex;
+        // A deque so the names handed out by GetStats stay valid as records are added.
+        std::deque<CreationRecord> m_records;
+    };
+
+    // Pipelines keyed by a hash of their full create info, identical requests share one reference counted pipeline.
+    // The 64-bit key is trusted, create infos are not compared on a hit.
+    class PipelineStateCache
+    {
+    public:
+        static uint64_t Hash(const GraphicsPipelineCreateInfo& createInfo);
+        static uint64_t Hash(const ComputePipelineCreateInfo& createInfo);
+        static uint64_t Hash(const RayTracingPipelineCreateInfo& createInfo);
+        static uint64_t Hash(const GraphicsPipelineLinkInfo& linkInfo);
+
+        // Returns the pipeline stored under key with an added reference. Otherwise inserts a new pipeline that is not
+        // ready yet and sets inserted, the caller is then responsible for its Init.
+        template<typename Pipeline>
+        Pipeline* FindOrInsert(uint64_t key, const char* name, bool& inserted)
+        {
+            std::lock_guard lock(m_mutex);
+            if (auto it = m_pipelines.find(key); it != m_pipelines.end())
+            {
+                m_hitCount++;
+                it->second->addRef();
+                inserted = false;
+                return static_cast<Pipeline*>(it->second);
+            }
+
+            m_missCount++;
+            Pipeline* pipeline = TL::construct<Pipeline>(name ? TL::StringView(name) : TL::StringView{});
+            pipeline->cacheKey = key;
+            pipeline->ready    = false;
+            m_pipelines[key]   = pipeline;
+            inserted           = true;
+            return pipeline;
+        }
+
+        // Drops a reference, returns true when it was the last one and the pipeline left the cache.
+        bool               Release(const ResourceBase* pipeline, uint64_t key);
+
+        // Removes a pipeline that failed to initialize, so later identical requests create it again. References
+        // already handed out stay valid until released.
+        void               Remove(const ResourceBase* pipeline, uint64_t key);
+
+        PipelineCacheStats GetStats();
+
+    private:
+        std::mutex                       m_mutex;
+        TL::Map<uint64_t, ResourceBase*> m_pipelines;
+        uint64_t                         m_hitCount  = 0;
+        uint64_t                         m_missCount = 0;
+    };
+
+    // Shader modules keyed by a hash of their SPIR-V, the same code arriving again shares one reference counted module.
+    // Like pipelines, the 64-bit key is trusted.
+    class ShaderModuleCache
+    {
+    public:
+        static uint64_t Hash(TL::Span<const uint32_t> code);
+
+        // Returns the module stored under key with an added reference, or null.
+        IShaderModule*  Find(uint64_t key);
+        // Inserts a module created outside the lock. When another thread inserted the same code first, that module is
+        // returned with an added reference and the caller destroys its own.
+        IShaderModule*  Insert(uint64_t key, IShaderModule* shaderModule);
+        // Returns the module without adding a reference, the caller must otherwise guarantee it stays alive.
+        IShaderModule*  Get(uint64_t key);
+        // Drops a reference, returns true when it was the last one and the module left the cache.
+        bool            Release(IShaderModule* shaderModule);
+
+    private:
+        std::mutex                        m_mutex;
+        TL::Map<uint64_t, IShaderModule*> m_shaderModules;
+    };
+
+    // Create infos of every pipeline compiled, saved to a file so a later run can precompile them at load time.
+    // Shader modules and layouts are stored as hashes of their content and resolved against the live ones on load.
+    class PipelineManifest
+    {
+    public:
+        struct Entries
+        {
+            TL::Vector<GraphicsPipelineDesc>   graphics;
+            TL::Vector<ComputePipelineDesc>    compute;
+            TL::Vector<RayTracingPipelineDesc> rayTracing;
+            // Entries referencing a shader module or layout that is not alive.
+            uint32_t                           unresolvedCount = 0;
+        };
+
+        static uint64_t Hash(const PipelineLayoutCreateInfo& createInfo);
+
+        // Recording is enabled with a path, entries already saved there are kept.
+        void            Init(const char* path);
+        void            Shutdown();
+        ResultCode      Save();
+
+        void            AddPipelineLayout(IPipelineLayout* layout);
+        void            RemovePipelineLayout(IPipelineLayout* layout);
+
+        void            Record(const GraphicsPipelineCreateInfo& createInfo);
+        void            Record(const ComputePipelineCreateInfo& createInfo);
+        void            Record(const RayTracingPipelineCreateInfo& createInfo);
+
+        // Reads the manifest at path, or the recorded one when null.
+        ResultCode      Load(const char* path, ShaderModuleCache& shaderModules, Entries& entries);
+
+    private:
+        void                Append(uint32_t kind, TL::Span<const uint8_t> payload);
+        // Serialize and Parse expect m_mutex to be held.
+        TL::Vector<uint8_t> Serialize() const;
+        bool                Parse(TL::Span<const uint8_t> data, ShaderModuleCache& shaderModules, Entries& entries);
+
+        TL::String                          m_path;
+        std::mutex                          m_mutex;
+        // Serialized entries, stored as they are written after the file header.
+        TL::Vector<uint8_t>                 m_entries;
+        uint32_t                            m_entryCount = 0;
+        // Payload hashes of the recorded entries, each unique create info is written once.
+        TL::Map<uint64_t, uint32_t>         m_recorded;
+        TL::Map<uint64_t, IPipelineLayout*> m_pipelineLayouts;
+    };
+} // namespace RHI::Vulkan
@@ -0,0 +1,158 @@
+#include "PipelineCompiler.hpp"
+#include "Device.hpp"
+
+#include <algorithm>
+
+#include <tracy/Tracy.hpp>
+
+namespace RHI::Vulkan
+{
+    ////////////////////////////////////////////////////////////////////////
+    // Pipeline descs
+    ////////////////////////////////////////////////////////////////////////
+
+    void ShaderStagesDesc::Copy(TL::Span<const PipelineShaderStage> srcStages)
+    {
+        for (const auto& stage : srcStages)
+        {
+            stages.push_back(stage);
+            entryPoints.push_back(stage.name ? stage.name : "");
+            specializationConstants.emplace_back(stage.specializationConstants.begin(), stage.specializationConstants.end());
+        }
+    }
+
+    TL::Span<const PipelineShaderStage> ShaderStagesDesc::Resolve()
+    {
+        for (size_t i = 0; i < stages.size(); ++i)
+        {
+            stages[i].name                    = entryPoints[i].c_str();
+            stages[i].specializationConstants = specializationConstants[i];
+        }
+        return stages;
+    }
+
+    GraphicsPipelineDesc::GraphicsPipelineDesc(const GraphicsPipelineCreateInfo& createInfo)
+        : createInfo(createInfo)
+    {
+        shaderStages.Copy(createInfo.shaderStages);
+        for (const auto& binding : createInfo.vertexBufferBindings)
+        {
+            vertexBindings.push_back(binding);
+            vertexAttributes.emplace_back(binding.attributes.begin(), binding.attributes.end());
+        }
+        colorFormats.assign(createInfo.renderTargetLayout.colors.begin(), createInfo.renderTargetLayout.colors.end());
+        blendStates.assign(createInfo.colorBlendState.blendStates.begin(), createInfo.colorBlendState.blendStates.end());
+    }
+
+    GraphicsPipelineCreateInfo GraphicsPipelineDesc::Resolve()
+    {
+        for (size_t i = 0; i < vertexBindings.size(); ++i)
+            vertexBindings[i].attributes = vertexAttributes[i];
+
+        createInfo.name                        = nullptr;
+        createInfo.shaderStages                = shaderStages.Resolve();
+        createInfo.vertexBufferBindings        = vertexBindings;
+        createInfo.renderTargetLayout.colors   = colorFormats;
+        createInfo.colorBlendState.blendStates = blendStates;
+        return createInfo;
+    }
+
+    ComputePipelineDesc::ComputePipelineDesc(const ComputePipelineCreateInfo& createInfo)
+        : createInfo(createInfo)
+    {
+        computeShader.Copy(TL::Span<const PipelineShaderStage>(&createInfo.computeShader, 1));
+    }
+
+    ComputePipelineCreateInfo ComputePipelineDesc::Resolve()
+    {
+        createInfo.name          = nullptr;
+        createInfo.computeShader = computeShader.Resolve()[0];
+        return createInfo;
+    }
+
+    RayTracingPipelineDesc::RayTracingPipelineDesc(const RayTracingPipelineCreateInfo& createInfo)
+        : createInfo(createInfo)
+        , shaderGroups(createInfo.shaderGroups.begin(), createInfo.shaderGroups.end())
+    {
+        shaderStages.Copy(createInfo.shaderStages);
+    }
+
+    RayTracingPipelineCreateInfo RayTracingPipelineDesc::Resolve()
+    {
+        createInfo.name         = nullptr;
+        createInfo.shaderStages = shaderStages.Resolve();
+        createInfo.shaderGroups = shaderGroups;
+        return createInfo;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // PipelineCompiler
+    ////////////////////////////////////////////////////////////////////////
+
+    ResultCode PipelineCompiler::Init([[maybe_unused]] IDevice* device, uint32_t workerCount)
+    {
+        if (workerCount == 0)
+            workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+        m_stop = false;
+        for (uint32_t i = 0; i < workerCount; ++i)
+            m_workers.emplace_back(&PipelineCompiler::WorkerMain, this);
+        return ResultCode::Success;
+    }
+
+    void PipelineCompiler::Shutdown()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+
+        for (auto& worker : m_workers)
+            worker.join();
+        m_workers.clear();
+    }
+
+    void PipelineCompiler::Enqueue(Task task)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+            m_pendingCount++;
+        }
+        m_condition.notify_one();
+    }
+
+    void PipelineCompiler::WaitIdle()
+    {
+        std::unique_lock lock(m_mutex);
+        m_idleCondition.wait(lock, [this]() { return m_pendingCount == 0; });
+    }
+
+    void PipelineCompiler::WorkerMain()
+    {
+        tracy::SetThreadName("Pipeline compiler");
+
+        while (true)
+        {
+            Task task;
+            {
+                std::unique_lock lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                    return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            {
+                ZoneScopedN("Compile pipeline");
+                task();
+            }
+
+            std::lock_guard lock(m_mutex);
+            if (--m_pendingCount == 0)
+                m_idleCondition.notify_all();
+        }
+    }
+} // namespace RHI::Vulkan
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <RHI/RHI.h>
+
+#include <TL/Containers/String.hpp>
+#include <TL/Containers/Vector.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace RHI::Vulkan
+{
+    class IDevice;
+
+    // Copies of the pipeline create infos owning every array they reference, so compilation can outlive the caller's data.
+    // Resolve points the spans of the returned create info at this object's storage.
+
+    struct ShaderStagesDesc
+    {
+        void                                Copy(TL::Span<const PipelineShaderStage> srcStages);
+        TL::Span<const PipelineShaderStage> Resolve();
+
+        TL::Vector<PipelineShaderStage>                stages;
+        TL::Vector<TL::String>                         entryPoints;
+        TL::Vector<TL::Vector<SpecializationConstant>> specializationConstants;
+    };
+
+    struct GraphicsPipelineDesc
+    {
+        explicit GraphicsPipelineDesc(const GraphicsPipelineCreateInfo& createInfo);
+
+        GraphicsPipelineCreateInfo Resolve();
+
+        GraphicsPipelineCreateInfo                          createInfo;
+        ShaderStagesDesc                                    shaderStages;
+        TL::Vector<PipelineVertexBindingDesc>               vertexBindings;
+        TL::Vector<TL::Vector<PipelineVertexAttributeDesc>> vertexAttributes;
+        TL::Vector<Format>                                  colorFormats;
+        TL::Vector<ColorAttachmentBlendStateDesc>           blendStates;
+    };
+
+    struct ComputePipelineDesc
+    {
+        explicit ComputePipelineDesc(const ComputePipelineCreateInfo& createInfo);
+
+        ComputePipelineCreateInfo Resolve();
+
+        ComputePipelineCreateInfo createInfo;
+        ShaderStagesDesc          computeShader;
+    };
+
+    struct RayTracingPipelineDesc
+    {
+        explicit RayTracingPipelineDesc(const RayTracingPipelineCreateInfo& createInfo);
+
+        RayTracingPipelineCreateInfo Resolve();
+
+        RayTracingPipelineCreateInfo                createInfo;
+        ShaderStagesDesc                            shaderStages;
+        TL::Vector<RayTracingShaderGroupCreateInfo> shaderGroups;
+    };
+
+    // Fixed pool of threads compiling pipelines in submission order.
+    class PipelineCompiler
+    {
+    public:
+        using Task = std::function<void()>;
+
+        ResultCode Init(IDevice* device, uint32_t workerCount);
+        // Runs every queued task before joining the workers.
+        void       Shutdown();
+
+        void       Enqueue(Task task);
+        // Blocks until every queued task ran, must not be called from a task.
+        void       WaitIdle();
+
+    private:
+        void WorkerMain();
+
+        std::mutex              m_mutex;
+        std::condition_variable m_condition;
+        std::condition_variable m_idleCondition;
+        std::deque<Task>        m_tasks;
+        TL::Vector<std::thread> m_workers;
+        // Queued and running tasks.
+        uint32_t                m_pendingCount = 0;
+        bool                    m_stop         = false;
+    };
+} // namespace RHI::Vulkan
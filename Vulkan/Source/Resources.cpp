@@ -264,29 +264,6 @@ namespace RHI::Vulkan
         return VK_SAMPLER_ADDRESS_MODE_MAX_ENUM;
     }
 
-    inline static VkCompareOp ConvertCompareOp(CompareOperator compareOperator)
-    {
-        switch (compareOperator)
-        {
-        case CompareOperator::Undefined:      return VK_COMPARE_OP_NEVER;
-        case CompareOperator::Never:          return VK_COMPARE_OP_NEVER;
-        case CompareOperator::Equal:          return VK_COMPARE_OP_EQUAL;
-        case CompareOperator::NotEqual:       return VK_COMPARE_OP_NOT_EQUAL;
-        case CompareOperator::Greater:        return VK_COMPARE_OP_GREATER;
-        case CompareOperator::GreaterOrEqual: return VK_COMPARE_OP_GREATER_OR_EQUAL;
-        case CompareOperator::Less:           return VK_COMPARE_OP_LESS;
-        case CompareOperator::LessOrEqual:    return VK_COMPARE_OP_LESS_OR_EQUAL;
-        case CompareOperator::Always:         return VK_COMPARE_OP_ALWAYS;
-        }
-        TL_UNREACHABLE();
-        return VK_COMPARE_OP_MAX_ENUM;
-    }
-
-    inline static VkBool32 ConvertBool(bool value)
-    {
-        return value ? VK_TRUE : VK_FALSE;
-    }
-
     inline static VkShaderStageFlagBits ConvertShaderStage(ShaderStage shaderStage)
     {
         switch (shaderStage)
@@ -343,19 +320,6 @@ namespace RHI::Vulkan
         return VK_VERTEX_INPUT_RATE_MAX_ENUM;
     }
 
-    inline static VkCullModeFlags ConvertCullModeFlags(PipelineRasterizerStateCullMode cullMode)
-    {
-        switch (cullMode)
-        {
-        case PipelineRasterizerStateCullMode::None:      return VK_CULL_MODE_NONE;
-        case PipelineRasterizerStateCullMode::FrontFace: return VK_CULL_MODE_FRONT_BIT;
-        case PipelineRasterizerStateCullMode::BackFace:  return VK_CULL_MODE_BACK_BIT;
-        case PipelineRasterizerStateCullMode::Discard:   return VK_CULL_MODE_FLAG_BITS_MAX_ENUM;
-        }
-        TL_UNREACHABLE();
-        return VK_CULL_MODE_FLAG_BITS_MAX_ENUM;
-    }
-
     inline static VkPolygonMode ConvertPolygonMode(PipelineRasterizerStateFillMode fillMode)
     {
         switch (fillMode)
@@ -380,17 +344,6 @@ namespace RHI::Vulkan
         return VK_PRIMITIVE_TOPOLOGY_MAX_ENUM;
     }
 
-    inline static VkFrontFace ConvertFrontFace(PipelineRasterizerStateFrontFace frontFace)
-    {
-        switch (frontFace)
-        {
-        case PipelineRasterizerStateFrontFace::Clockwise:        return VK_FRONT_FACE_CLOCKWISE;
-        case PipelineRasterizerStateFrontFace::CounterClockwise: return VK_FRONT_FACE_COUNTER_CLOCKWISE;
-        }
-        TL_UNREACHABLE();
-        return VK_FRONT_FACE_MAX_ENUM;
-    }
-
     inline static VkBlendFactor ConvertBlendFactor(BlendFactor blendFactor)
     {
         switch (blendFactor)
@@ -428,6 +381,16 @@ namespace RHI::Vulkan
         return VK_BLEND_OP_MAX_ENUM;
     }
 
+    inline static VkColorComponentFlags ConvertColorWriteMask(TL::Flags<ColorWriteMask> writeMask)
+    {
+        VkColorComponentFlags flags = 0;
+        if (writeMask & ColorWriteMask::Red) flags |= VK_COLOR_COMPONENT_R_BIT;
+        if (writeMask & ColorWriteMask::Green) flags |= VK_COLOR_COMPONENT_G_BIT;
+        if (writeMask & ColorWriteMask::Blue) flags |= VK_COLOR_COMPONENT_B_BIT;
+        if (writeMask & ColorWriteMask::Alpha) flags |= VK_COLOR_COMPONENT_A_BIT;
+        return flags;
+    }
+
     inline static VkDescriptorType ConvertDescriptorType(BindingType bindingType)
     {
         switch (bindingType)
@@ -624,6 +587,45 @@ namespace RHI::Vulkan
     // BindGroupAllocator
     ////////////////////////////////////////////////////////////////////////
 
+    // Shared by every bind group on the descriptor buffer path, clamped to the device's range limits.
+    static constexpr VkDeviceSize DescriptorBufferSize = 64 << 20;
+
+    // Transient bind groups, a frame chains more pools or chunks when one fills up.
+    static constexpr uint32_t     TransientPoolSetCount        = 1024;
+    static constexpr uint32_t     TransientPoolDescriptorCount = 1024;
+    static constexpr VkDeviceSize TransientChunkSize           = 256 << 10;
+
+    inline static size_t GetDescriptorSize(IDevice* device, VkDescriptorType descriptorType)
+    {
+        const auto& properties = device->m_descriptorBufferProperties;
+        switch (descriptorType)
+        {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:                    return properties.samplerDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:              return properties.sampledImageDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:              return properties.storageImageDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:       return properties.uniformTexelBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:       return properties.storageTexelBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:             return properties.uniformBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:             return properties.storageBufferDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:           return properties.inputAttachmentDescriptorSize;
+        case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR: return properties.accelerationStructureDescriptorSize;
+        default:                                            break;
+        }
+        TL_UNREACHABLE();
+        return 0;
+    }
+
+    inline static VkDeviceSize GetBindGroupDescriptorSize(IDevice* device, IBindGroupLayout* bindGroupLayout, uint32_t bindlessResourcesCount)
+    {
+        if (!bindGroupLayout->hasBindless)
+            return bindGroupLayout->descriptorSize;
+
+        // The variable count binding is the last one, only the requested count is allocated.
+        uint32_t         binding        = uint32_t(bindGroupLayout->shaderBindings.size() - 1);
+        VkDescriptorType descriptorType = ConvertDescriptorType(bindGroupLayout->shaderBindings[binding].type);
+        return bindGroupLayout->bindingOffsets[binding] + bindlessResourcesCount * GetDescriptorSize(device, descriptorType);
+    }
+
     BindGroupAllocator::BindGroupAllocator()  = default;
     BindGroupAllocator::~BindGroupAllocator() = default;
 
@@ -631,6 +633,62 @@ namespace RHI::Vulkan
     {
         m_device = device;
 
+        if (m_device->GetFeatures().hasDescriptorBuffer)
+        {
+            const auto& properties = m_device->m_descriptorBufferProperties;
+
+            // Groups mixing samplers and resources live in the same buffer, so both range limits apply.
+            VkDeviceSize capacity = std::min({DescriptorBufferSize, properties.maxResourceDescriptorBufferRange, properties.maxSamplerDescriptorBufferRange});
+
+            VkBufferUsageFlags usageFlags =
+                VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+            if (!properties.bufferlessPushDescriptors)
+                usageFlags |= VK_BUFFER_USAGE_PUSH_DESCRIPTORS_DESCRIPTOR_BUFFER_BIT_EXT;
+
+            VkBufferCreateInfo bufferCI{
+                .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                .pNext                 = nullptr,
+                .flags                 = 0,
+                .size                  = capacity,
+                .usage                 = usageFlags,
+                .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+                .queueFamilyIndexCount = 0,
+                .pQueueFamilyIndices   = nullptr,
+            };
+            // Only ever written by the CPU, device local memory is preferred when it is host visible.
+            VmaAllocationCreateInfo allocationCI{
+                .flags          = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+                .usage          = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+                .requiredFlags  = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                .preferredFlags = 0,
+                .memoryTypeBits = 0,
+                .pool           = VK_NULL_HANDLE,
+                .pUserData      = nullptr,
+                .priority       = 0.0f,
+            };
+            VmaAllocationInfo allocationInfo{};
+            VkResult          result = vmaCreateBuffer(m_device->m_deviceAllocator, &bufferCI, &allocationCI, &m_descriptorBuffer, &m_descriptorBufferAllocation, &allocationInfo);
+            if (result != VK_SUCCESS)
+                return result;
+
+            m_device->SetDebugName(m_descriptorBuffer, "Descriptor buffer");
+            m_descriptorBufferPtr = (uint8_t*)allocationInfo.pMappedData;
+
+            VkBufferDeviceAddressInfo addressInfo{
+                .sType  = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .pNext  = nullptr,
+                .buffer = m_descriptorBuffer,
+            };
+            m_descriptorBufferAddress = vkGetBufferDeviceAddress(m_device->m_device, &addressInfo);
+
+            VmaVirtualBlockCreateInfo blockCI{
+                .size                 = capacity,
+                .flags                = 0,
+                .pAllocationCallbacks = nullptr,
+            };
+            return vmaCreateVirtualBlock(&blockCI, &m_descriptorBufferBlock);
+        }
+
         /// @todo: (don't do this)
         VkDescriptorPoolSize poolSizes[] = {
             {VK_DESCRIPTOR_TYPE_SAMPLER, 2048 * 10},
@@ -664,12 +722,31 @@ namespace RHI::Vulkan
 
     void BindGroupAllocator::Shutdown()
     {
+        if (m_descriptorBuffer != VK_NULL_HANDLE)
+        {
+            // Bind groups leaked by the application still hold ranges of the block.
+            vmaClearVirtualBlock(m_descriptorBufferBlock);
+            vmaDestroyVirtualBlock(m_descriptorBufferBlock);
+            vmaDestroyBuffer(m_device->m_deviceAllocator, m_descriptorBuffer, m_descriptorBufferAllocation);
+            return;
+        }
+
         vkResetDescriptorPool(m_device->m_device, m_descriptorPool, 0);
         vkDestroyDescriptorPool(m_device->m_device, m_descriptorPool, nullptr);
     }
 
     ResultCode BindGroupAllocator::InitBindGroup(IBindGroup* bindGroup, IBindGroupLayout* bindGroupLayout, uint32_t bindlessResourcesCount)
     {
+        if (m_device->GetFeatures().hasDescriptorBuffer)
+        {
+            bindGroup->descriptorSet = VK_NULL_HANDLE;
+
+            VkDeviceSize size = GetBindGroupDescriptorSize(m_device, bindGroupLayout, bindlessResourcesCount);
+            if (size == 0)
+                return ResultCode::Success;
+            return AllocateDescriptorRange(size, bindGroup->descriptorAllocation, bindGroup->descriptorOffset);
+        }
+
         VkDescriptorSetVariableDescriptorCountAllocateInfo variableDescriptorCountInfo{
             .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO,
             .pNext              = nullptr,
@@ -692,15 +769,297 @@ namespace RHI::Vulkan
 
     void BindGroupAllocator::ShutdownBindGroup(IBindGroup* bindGroup)
     {
-        // todo this should be deleted throuh deletion queue
-        vkFreeDescriptorSets(m_device->m_device, m_descriptorPool, 1, &bindGroup->descriptorSet);
+        auto frame = m_device->GetLastSubmitValues();
+        if (m_device->GetFeatures().hasDescriptorBuffer)
+        {
+            if (bindGroup->descriptorAllocation != VK_NULL_HANDLE)
+                m_device->m_destroyQueue->Push(frame, bindGroup->descriptorAllocation);
+            return;
+        }
+
+        m_device->m_destroyQueue->Push(frame, bindGroup->descriptorSet);
+    }
+
+    ResultCode BindGroupAllocator::AllocateDescriptorRange(VkDeviceSize size, VmaVirtualAllocation& allocation, VkDeviceSize& offset)
+    {
+        VmaVirtualAllocationCreateInfo allocationCI{
+            .size      = size,
+            .alignment = m_device->m_descriptorBufferProperties.descriptorBufferOffsetAlignment,
+            .flags     = 0,
+            .pUserData = nullptr,
+        };
+
+        std::lock_guard lock{m_descriptorBufferMutex};
+        if (vmaVirtualAllocate(m_descriptorBufferBlock, &allocationCI, &allocation, &offset) != VK_SUCCESS)
+        {
+            TL::LogError("Descriptor buffer is out of space, {} bytes requested", size);
+            return ResultCode::ErrorPoolOutOfMemory;
+        }
+        return ResultCode::Success;
+    }
+
+    void BindGroupAllocator::FreeDescriptorRange(VmaVirtualAllocation allocation)
+    {
+        std::lock_guard lock{m_descriptorBufferMutex};
+        vmaVirtualFree(m_descriptorBufferBlock, allocation);
+    }
+
+    void BindGroupAllocator::WriteBindGroup(IBindGroup* bindGroup, const BindGroupUpdateInfo& updateInfo)
+    {
+        IBindGroupLayout* layout = bindGroup->bindGroupLayout;
+        uint8_t*          dst    = m_descriptorBufferPtr + bindGroup->descriptorOffset;
+
+        auto writeDescriptor = [&](uint32_t binding, uint32_t arrayElement, const VkDescriptorGetInfoEXT& getInfo)
+        {
+            size_t descriptorSize = GetDescriptorSize(m_device, getInfo.type);
+            vkGetDescriptorEXT(m_device->m_device, &getInfo, descriptorSize, dst + layout->bindingOffsets[binding] + arrayElement * descriptorSize);
+        };
+
+        for (auto [dstBinding, dstArrayElement, buffers] : updateInfo.buffers)
+        {
+            VkDescriptorType descriptorType = ConvertDescriptorType(layout->GetBinding(dstBinding).type);
+            TL_ASSERT(descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, "Only uniform and storage buffers can be bound through the descriptor buffer");
+
+            for (uint32_t i = 0; i < buffers.size(); ++i)
+            {
+                auto buffer = (IBuffer*)(buffers[i].buffer);
+                auto offset = buffers[i].offset;
+                auto range  = (buffers[i].range == RemainingSize) ? buffer->size - offset : buffers[i].range;
+
+                VkDescriptorAddressInfoEXT addressInfo{
+                    .sType   = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+                    .pNext   = nullptr,
+                    .address = buffer->address + offset,
+                    .range   = range,
+                    .format  = VK_FORMAT_UNDEFINED,
+                };
+                VkDescriptorGetInfoEXT getInfo{
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                    .pNext = nullptr,
+                    .type  = descriptorType,
+                    .data  = descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ? VkDescriptorDataEXT{.pUniformBuffer = &addressInfo} : VkDescriptorDataEXT{.pStorageBuffer = &addressInfo},
+                };
+                writeDescriptor(dstBinding, dstArrayElement + i, getInfo);
+            }
+        }
+
+        for (auto [dstBinding, dstArrayElement, images] : updateInfo.images)
+        {
+            // Same layout rules as DescriptorSetWriter::BindImages.
+            bool isStorage = layout->GetBinding(dstBinding).type == BindingType::StorageImage;
+
+            for (uint32_t i = 0; i < images.size(); ++i)
+            {
+                VkDescriptorImageInfo imageInfo{
+                    .sampler     = VK_NULL_HANDLE,
+                    .imageView   = ((IImage*)images[i])->viewHandle,
+                    .imageLayout = isStorage ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                };
+                VkDescriptorGetInfoEXT getInfo{
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                    .pNext = nullptr,
+                    .type  = isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                    .data  = isStorage ? VkDescriptorDataEXT{.pStorageImage = &imageInfo} : VkDescriptorDataEXT{.pSampledImage = &imageInfo},
+                };
+                writeDescriptor(dstBinding, dstArrayElement + i, getInfo);
+            }
+        }
+
+        for (auto [dstBinding, dstArrayElement, samplers] : updateInfo.samplers)
+        {
+            for (uint32_t i = 0; i < samplers.size(); ++i)
+            {
+                VkDescriptorGetInfoEXT getInfo{
+                    .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                    .pNext = nullptr,
+                    .type  = VK_DESCRIPTOR_TYPE_SAMPLER,
+                    .data  = {.pSampler = &((ISampler*)samplers[i])->handle},
+                };
+                writeDescriptor(dstBinding, dstArrayElement + i, getInfo);
+            }
+        }
+
+        for (auto [dstBinding, dstArrayElement, accelerationStructure] : updateInfo.accelerationStructures)
+        {
+            VkDescriptorGetInfoEXT getInfo{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .pNext = nullptr,
+                .type  = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
+                .data  = {.accelerationStructure = ((IAccelerationStructure*)accelerationStructure)->address},
+            };
+            writeDescriptor(dstBinding, dstArrayElement, getInfo);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // TransientBindGroupAllocator
+    ////////////////////////////////////////////////////////////////////////
+
+    void TransientBindGroupAllocator::Init(IDevice* device)
+    {
+        m_device = device;
+    }
+
+    void TransientBindGroupAllocator::Shutdown()
+    {
+        Reset();
+
+        for (VkDescriptorPool descriptorPool : m_descriptorPools)
+            vkDestroyDescriptorPool(m_device->m_device, descriptorPool, nullptr);
+        m_descriptorPools.clear();
+
+        for (const DescriptorChunk& chunk : m_descriptorChunks)
+            m_device->m_bindGroupAllocator.FreeDescriptorRange(chunk.allocation);
+        m_descriptorChunks.clear();
+    }
+
+    IBindGroup* TransientBindGroupAllocator::Allocate(const BindGroupCreateInfo& createInfo)
+    {
+        ZoneScoped;
+
+        auto bindGroup             = TL::construct<IBindGroup>(createInfo.name ? TL::StringView(createInfo.name) : TL::StringView{});
+        bindGroup->bindGroupLayout = (IBindGroupLayout*)(createInfo.layout);
+        bindGroup->transient       = true;
+
+        std::lock_guard lock{m_mutex};
+
+        ResultCode result = m_device->GetFeatures().hasDescriptorBuffer
+                                ? AllocateDescriptorRange(bindGroup, createInfo.bindlessArrayCount)
+                                : AllocateDescriptorSet(bindGroup, createInfo.bindlessArrayCount);
+        if (IsError(result))
+        {
+            TL::destruct(bindGroup);
+            return nullptr;
+        }
+
+        m_bindGroups.push_back(bindGroup);
+        return bindGroup;
+    }
+
+    void TransientBindGroupAllocator::Reset()
+    {
+        ZoneScoped;
+
+        std::lock_guard lock{m_mutex};
+
+        for (IBindGroup* bindGroup : m_bindGroups)
+            TL::destruct(bindGroup);
+        m_bindGroups.clear();
+
+        // Returns every set of the pool at once, the pools and chunks themselves are kept for the next frame.
+        for (VkDescriptorPool descriptorPool : m_descriptorPools)
+            vkResetDescriptorPool(m_device->m_device, descriptorPool, 0);
+
+        m_descriptorPoolIndex  = 0;
+        m_descriptorChunkIndex = 0;
+        m_descriptorChunkUsed  = 0;
+    }
+
+    ResultCode TransientBindGroupAllocator::AllocateDescriptorSet(IBindGroup* bindGroup, uint32_t bindlessResourcesCount)
+    {
+        IBindGroupLayout* bindGroupLayout = bindGroup->bindGroupLayout;
+
+        VkDescriptorSetVariableDescriptorCountAllocateInfo variableDescriptorCountInfo{
+            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO,
+            .pNext              = nullptr,
+            .descriptorSetCount = 1,
+            .pDescriptorCounts  = &bindlessResourcesCount,
+        };
+
+        // Pools past the current one are empty, a set that does not fit into the next one never will.
+        for (uint32_t attempt = 0; attempt < 2; ++attempt)
+        {
+            if (m_descriptorPoolIndex == m_descriptorPools.size())
+            {
+                VkDescriptorPoolSize poolSizes[] = {
+                    {VK_DESCRIPTOR_TYPE_SAMPLER, TransientPoolDescriptorCount},
+                    {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, TransientPoolDescriptorCount},
+                    {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, TransientPoolDescriptorCount},
+                    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, TransientPoolDescriptorCount},
+                    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, TransientPoolDescriptorCount},
+                    {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, TransientPoolDescriptorCount},
+                    {VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, TransientPoolDescriptorCount},
+                    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, TransientPoolDescriptorCount},
+                    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, TransientPoolDescriptorCount},
+                    {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, TransientPoolDescriptorCount},
+                    {VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, TransientPoolDescriptorCount},
+                };
+                uint32_t poolSizeCount = sizeof(poolSizes) / sizeof(VkDescriptorPoolSize);
+                if (!m_device->GetFeatures().hasRaytracing)
+                    poolSizeCount--;
+
+                // No FREE_DESCRIPTOR_SET_BIT, sets are only ever released by resetting the pool. Bindless and
+                // partially bound layouts still need an update after bind pool.
+                VkDescriptorPoolCreateInfo poolCI{
+                    .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                    .pNext         = nullptr,
+                    .flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+                    .maxSets       = TransientPoolSetCount,
+                    .poolSizeCount = poolSizeCount,
+                    .pPoolSizes    = poolSizes,
+                };
+                VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+                VulkanResult     result         = vkCreateDescriptorPool(m_device->m_device, &poolCI, nullptr, &descriptorPool);
+                if (result.IsError())
+                    return result;
+                m_descriptorPools.push_back(descriptorPool);
+            }
+
+            VkDescriptorSetAllocateInfo allocateInfo{
+                .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                .pNext              = bindGroupLayout->hasBindless ? &variableDescriptorCountInfo : nullptr,
+                .descriptorPool     = m_descriptorPools[m_descriptorPoolIndex],
+                .descriptorSetCount = 1,
+                .pSetLayouts        = &bindGroupLayout->handle,
+            };
+            VkResult result = vkAllocateDescriptorSets(m_device->m_device, &allocateInfo, &bindGroup->descriptorSet);
+            if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+                return VulkanResult(result);
+
+            m_descriptorPoolIndex++;
+        }
+
+        TL::LogError("Transient bind group does not fit into an empty descriptor pool");
+        return ResultCode::ErrorPoolOutOfMemory;
+    }
+
+    ResultCode TransientBindGroupAllocator::AllocateDescriptorRange(IBindGroup* bindGroup, uint32_t bindlessResourcesCount)
+    {
+        bindGroup->descriptorSet = VK_NULL_HANDLE;
+
+        VkDeviceSize size = GetBindGroupDescriptorSize(m_device, bindGroup->bindGroupLayout, bindlessResourcesCount);
+        if (size == 0)
+            return ResultCode::Success;
+
+        // Chunk offsets are already aligned, so aligning within the chunk is enough.
+        VkDeviceSize alignment = m_device->m_descriptorBufferProperties.descriptorBufferOffsetAlignment;
+        for (; m_descriptorChunkIndex < m_descriptorChunks.size(); m_descriptorChunkIndex++, m_descriptorChunkUsed = 0)
+        {
+            const DescriptorChunk& chunk  = m_descriptorChunks[m_descriptorChunkIndex];
+            VkDeviceSize           offset = AlignUp(m_descriptorChunkUsed, alignment);
+            if (offset + size <= chunk.size)
+            {
+                bindGroup->descriptorOffset = chunk.offset + offset;
+                m_descriptorChunkUsed       = offset + size;
+                return ResultCode::Success;
+            }
+        }
+
+        DescriptorChunk chunk{.allocation = VK_NULL_HANDLE, .offset = 0, .size = std::max(TransientChunkSize, size)};
+        if (auto result = m_device->m_bindGroupAllocator.AllocateDescriptorRange(chunk.size, chunk.allocation, chunk.offset); IsError(result))
+            return result;
+
+        m_descriptorChunks.push_back(chunk);
+        bindGroup->descriptorOffset = chunk.offset;
+        m_descriptorChunkUsed       = size;
+        return ResultCode::Success;
     }
 
     ////////////////////////////////////////////////////////////////////////
     // IBindGroupLayout
     ////////////////////////////////////////////////////////////////////////
 
-    ResultCode IBindGroupLayout::Init(IDevice* device, const BindGroupLayoutCreateInfo& createInfo)
+    ResultCode IBindGroupLayout::Init(IDevice* device, const BindGroupLayoutCreateInfo& createInfo, bool partiallyBound)
     {
         this->shaderBindings = {createInfo.bindings.begin(), createInfo.bindings.end()};
 
@@ -725,8 +1084,11 @@ namespace RHI::Vulkan
         TL_MAYBE_UNUSED uint32_t maxStorageBuffers        = properties.properties.limits.maxPerStageDescriptorStorageBuffers;
         TL_MAYBE_UNUSED uint32_t maxCombinedImageSamplers = properties.properties.limits.maxPerStageDescriptorSampledImages + properties.properties.limits.maxPerStageDescriptorSamplers;
 
+        // Descriptor buffers have no update-after-bind pools, so the regular per stage limit applies.
+        bool useDescriptorBuffer = device->GetFeatures().hasDescriptorBuffer;
+
         /// @todo: subtract 100 to reserve for pass inputs
-        uint32_t                 maxBindlessSampledImages  = descriptorIndexingProps.maxPerStageDescriptorUpdateAfterBindSampledImages - 100;
+        uint32_t                 maxBindlessSampledImages  = (useDescriptorBuffer ? maxSampledImages : descriptorIndexingProps.maxPerStageDescriptorUpdateAfterBindSampledImages) - 100;
         TL_MAYBE_UNUSED uint32_t maxBindlessStorageImages  = descriptorIndexingProps.maxPerStageDescriptorUpdateAfterBindStorageImages;
         TL_MAYBE_UNUSED uint32_t maxBindlessSamplers       = descriptorIndexingProps.maxPerStageDescriptorUpdateAfterBindSamplers;
         TL_MAYBE_UNUSED uint32_t maxBindlessUniformBuffers = descriptorIndexingProps.maxPerStageDescriptorUpdateAfterBindUniformBuffers;
@@ -739,6 +1101,12 @@ namespace RHI::Vulkan
 
             auto isBindless = binding.arrayCount == BindlessArraySize;
 
+            if (useDescriptorBuffer && (binding.type == BindingType::UniformBufferDynamic || binding.type == BindingType::StorageBufferDynamic))
+            {
+                TL::LogError("Dynamic bindings are not supported with descriptor buffers (binding {})", bindingIndex);
+                return ResultCode::ErrorInvalidArguments;
+            }
+
             VkDescriptorSetLayoutBinding layoutBinding{
                 .binding            = bindingIndex,
                 .descriptorType     = ConvertDescriptorType(binding.type),
@@ -752,12 +1120,20 @@ namespace RHI::Vulkan
             {
                 VkDescriptorBindingFlags flags =
                     VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT |
-                    VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
-                    VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
-                    VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+                    VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+                // Descriptor buffer memory is written directly, updating it after bind needs no flags.
+                if (!useDescriptorBuffer)
+                    flags |= VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
                 bindingFlags.push_back(flags);
                 hasBindless = true;
             }
+            else if (partiallyBound)
+            {
+                VkDescriptorBindingFlags flags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+                if (!useDescriptorBuffer)
+                    flags |= VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+                bindingFlags.push_back(flags);
+            }
             else
             {
                 bindingFlags.push_back(0);
@@ -775,12 +1151,14 @@ namespace RHI::Vulkan
         VkDescriptorSetLayoutCreateFlags layoutFlags = 0;
         if (createInfo.pushable)
             layoutFlags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT;
-        if (hasBindless)
+        if (useDescriptorBuffer)
+            layoutFlags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        else if (hasBindless || partiallyBound)
             layoutFlags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
 
         VkDescriptorSetLayoutCreateInfo layoutCI{
             .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-            .pNext        = hasBindless ? &layoutBindingFlagsCI : nullptr,
+            .pNext        = (hasBindless || partiallyBound) ? &layoutBindingFlagsCI : nullptr,
             .flags        = layoutFlags,
             .bindingCount = (uint32_t)setLayoutBindings.size(),
             .pBindings    = setLayoutBindings.data(),
@@ -793,14 +1171,98 @@ namespace RHI::Vulkan
         {
             device->SetDebugName(handle, getName().c_str());
         }
+        if (result.IsSuccess() && useDescriptorBuffer)
+        {
+            vkGetDescriptorSetLayoutSizeEXT(device->m_device, handle, &descriptorSize);
+            bindingOffsets.resize(setLayoutBindings.size());
+            for (uint32_t bindingIndex = 0; bindingIndex < bindingOffsets.size(); bindingIndex++)
+                vkGetDescriptorSetLayoutBindingOffsetEXT(device->m_device, handle, bindingIndex, &bindingOffsets[bindingIndex]);
+        }
+        // Bindless and partially bound arrays are updated sparsely, a template would rewrite all of them.
+        if (result.IsSuccess() && !useDescriptorBuffer && !createInfo.pushable && !hasBindless && !partiallyBound)
+            return InitUpdateTemplate(device);
         return result;
     }
 
     void IBindGroupLayout::Shutdown(IDevice* device)
     {
+        if (updateTemplate != VK_NULL_HANDLE)
+            vkDestroyDescriptorUpdateTemplate(device->m_device, updateTemplate, nullptr);
         vkDestroyDescriptorSetLayout(device->m_device, handle, nullptr);
     }
 
+    inline static uint32_t GetUpdateTemplateStride(VkDescriptorType descriptorType)
+    {
+        switch (descriptorType)
+        {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:              return sizeof(VkDescriptorImageInfo);
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:     return sizeof(VkDescriptorBufferInfo);
+        case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR: return sizeof(VkAccelerationStructureKHR);
+        default:                                            return 0;
+        }
+    }
+
+    ResultCode IBindGroupLayout::InitUpdateTemplate(IDevice* device)
+    {
+        TL::Vector<VkDescriptorUpdateTemplateEntry> entries{device->m_arena};
+        templateOffsets.resize(shaderBindings.size());
+        templateFirstDescriptor.resize(shaderBindings.size());
+
+        for (uint32_t bindingIndex = 0; bindingIndex < shaderBindings.size(); bindingIndex++)
+        {
+            const ShaderBinding& binding        = shaderBindings[bindingIndex];
+            VkDescriptorType     descriptorType = ConvertDescriptorType(binding.type);
+            uint32_t             stride         = GetUpdateTemplateStride(descriptorType);
+            if (stride == 0)
+            {
+                // Texel buffers and input attachments keep going through DescriptorSetWriter.
+                templateOffsets.clear();
+                templateFirstDescriptor.clear();
+                templateDataSize        = 0;
+                templateDescriptorCount = 0;
+                return ResultCode::Success;
+            }
+
+            VkDescriptorUpdateTemplateEntry entry{
+                .dstBinding      = bindingIndex,
+                .dstArrayElement = 0,
+                .descriptorCount = binding.arrayCount,
+                .descriptorType  = descriptorType,
+                .offset          = templateDataSize,
+                .stride          = stride,
+            };
+            entries.push_back(entry);
+
+            templateOffsets[bindingIndex]         = templateDataSize;
+            templateFirstDescriptor[bindingIndex] = templateDescriptorCount;
+            templateDataSize += binding.arrayCount * stride;
+            templateDescriptorCount += binding.arrayCount;
+        }
+
+        if (entries.empty())
+            return ResultCode::Success;
+
+        VkDescriptorUpdateTemplateCreateInfo templateCI{
+            .sType                      = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+            .pNext                      = nullptr,
+            .flags                      = 0,
+            .descriptorUpdateEntryCount = (uint32_t)entries.size(),
+            .pDescriptorUpdateEntries   = entries.data(),
+            .templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+            .descriptorSetLayout        = handle,
+            .pipelineBindPoint          = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .pipelineLayout             = VK_NULL_HANDLE,
+            .set                        = 0,
+        };
+        VulkanResult result = vkCreateDescriptorUpdateTemplate(device->m_device, &templateCI, nullptr, &updateTemplate);
+        return result;
+    }
+
     ////////////////////////////////////////////////////////////////////////
     // IBindGroup
     ////////////////////////////////////////////////////////////////////////
@@ -810,8 +1272,14 @@ namespace RHI::Vulkan
         this->bindGroupLayout = (IBindGroupLayout*)(createInfo.layout);
 
         ResultCode result = device->m_bindGroupAllocator.InitBindGroup(this, this->bindGroupLayout, createInfo.bindlessArrayCount);
-        if (IsSuccess(result) && !getName().empty())
+        if (IsSuccess(result) && descriptorSet != VK_NULL_HANDLE && !getName().empty())
             device->SetDebugName(descriptorSet, getName().c_str());
+
+        if (bindGroupLayout->updateTemplate != VK_NULL_HANDLE)
+        {
+            templateData.resize(bindGroupLayout->templateDataSize);
+            templateWritten.resize(bindGroupLayout->templateDescriptorCount);
+        }
         return result;
     }
 
@@ -824,6 +1292,18 @@ namespace RHI::Vulkan
     {
         ZoneScoped;
 
+        if (device->GetFeatures().hasDescriptorBuffer)
+        {
+            device->m_bindGroupAllocator.WriteBindGroup(this, updateInfo);
+            return;
+        }
+
+        if (!templateData.empty() && PackTemplateData(updateInfo))
+        {
+            vkUpdateDescriptorSetWithTemplate(device->m_device, this->descriptorSet, this->bindGroupLayout->updateTemplate, templateData.data());
+            return;
+        }
+
         DescriptorSetWriter writer(device, this->descriptorSet, this->bindGroupLayout, device->m_arena);
 
         for (auto [dstBindings, dstArrayelements, buffers] : updateInfo.buffers)
@@ -849,6 +1329,74 @@ namespace RHI::Vulkan
         vkUpdateDescriptorSets(device->m_device, (uint32_t)writer.GetWrites().size(), writer.GetWrites().data(), 0, nullptr);
     }
 
+    bool IBindGroup::PackTemplateData(const BindGroupUpdateInfo& updateInfo)
+    {
+        IBindGroupLayout* layout  = this->bindGroupLayout;
+        uint32_t          pending = layout->templateDescriptorCount;
+        std::fill(templateWritten.begin(), templateWritten.end(), false);
+
+        auto writeDescriptor = [&](uint32_t binding, uint32_t arrayElement, const auto& descriptor)
+        {
+            TL_ASSERT(arrayElement < layout->shaderBindings[binding].arrayCount);
+            memcpy(templateData.data() + layout->templateOffsets[binding] + arrayElement * sizeof(descriptor), &descriptor, sizeof(descriptor));
+
+            uint32_t descriptorIndex = layout->templateFirstDescriptor[binding] + arrayElement;
+            if (!templateWritten[descriptorIndex])
+            {
+                templateWritten[descriptorIndex] = true;
+                pending--;
+            }
+        };
+
+        for (auto [dstBinding, dstArrayElement, buffers] : updateInfo.buffers)
+        {
+            for (uint32_t i = 0; i < buffers.size(); i++)
+            {
+                VkDescriptorBufferInfo descriptorInfo{
+                    .buffer = ((IBuffer*)buffers[i].buffer)->handle,
+                    .offset = buffers[i].offset,
+                    .range  = (buffers[i].range == RemainingSize) ? VK_WHOLE_SIZE : buffers[i].range,
+                };
+                writeDescriptor(dstBinding, dstArrayElement + i, descriptorInfo);
+            }
+        }
+
+        for (auto [dstBinding, dstArrayElement, images] : updateInfo.images)
+        {
+            // Same layout rules as DescriptorSetWriter::BindImages.
+            bool          isStorage   = layout->GetBinding(dstBinding).type == BindingType::StorageImage;
+            VkImageLayout imageLayout = isStorage ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            for (uint32_t i = 0; i < images.size(); i++)
+            {
+                VkDescriptorImageInfo descriptorInfo{
+                    .sampler     = VK_NULL_HANDLE,
+                    .imageView   = ((IImage*)images[i])->viewHandle,
+                    .imageLayout = imageLayout,
+                };
+                writeDescriptor(dstBinding, dstArrayElement + i, descriptorInfo);
+            }
+        }
+
+        for (auto [dstBinding, dstArrayElement, samplers] : updateInfo.samplers)
+        {
+            for (uint32_t i = 0; i < samplers.size(); i++)
+            {
+                VkDescriptorImageInfo descriptorInfo{
+                    .sampler     = ((ISampler*)samplers[i])->handle,
+                    .imageView   = VK_NULL_HANDLE,
+                    .imageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                };
+                writeDescriptor(dstBinding, dstArrayElement + i, descriptorInfo);
+            }
+        }
+
+        for (auto [dstBinding, dstArrayElement, accelerationStructure] : updateInfo.accelerationStructures)
+        {
+            writeDescriptor(dstBinding, dstArrayElement, ((IAccelerationStructure*)accelerationStructure)->handle);
+        }
+        return pending == 0;
+    }
+
     ////////////////////////////////////////////////////////////////////////
     // IFence
     ////////////////////////////////////////////////////////////////////////
@@ -876,7 +1424,7 @@ namespace RHI::Vulkan
 
     void IFence::Shutdown(IDevice* device)
     {
-        auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+        auto frame = device->GetLastSubmitValues();
         if (semaphore)
             device->m_destroyQueue->Push(frame, semaphore);
     }
@@ -910,6 +1458,10 @@ namespace RHI::Vulkan
         VulkanResult result = vkCreateShaderModule(device->m_device, &shaderModuleCI, nullptr, &m_shaderModule);
         if (result == VK_SUCCESS && !getName().empty())
             device->SetDebugName(m_shaderModule, getName().c_str());
+        if (device->GetFeatures().hasShaderObject)
+            m_code.assign(createInfo.code.begin(), createInfo.code.end());
+        if (result == VK_SUCCESS && device->GetFeatures().hasShaderModuleIdentifier)
+            vkGetShaderModuleIdentifierEXT(device->m_device, m_shaderModule, &m_identifier);
         return result;
     }
 
@@ -924,16 +1476,18 @@ namespace RHI::Vulkan
 
     ResultCode IPipelineLayout::Init(IDevice* device, const PipelineLayoutCreateInfo& createInfo)
     {
-        TL::Vector<VkDescriptorSetLayout> descriptorSetLayouts{device->m_arena};
-        uint32_t                          index = 0;
+        contentHash = PipelineManifest::Hash(createInfo);
+
+        uint32_t index = 0;
         for (auto bindGroupLayout : createInfo.layouts)
         {
             auto layout = (IBindGroupLayout*)(bindGroupLayout);
-            descriptorSetLayouts.push_back(layout->handle);
+            setLayouts.push_back(layout->handle);
+            if (layout == device->m_bindlessHeap.GetLayout())
+                bindlessGroup = index;
             this->bindGroupLayouts[index++] = (IBindGroupLayout*)bindGroupLayout;
         }
 
-        TL::Vector<VkPushConstantRange> pushConstantRanges{device->m_arena};
         pushConstantStages = 0;
         for (auto range : createInfo.pushConstants)
         {
@@ -950,8 +1504,8 @@ namespace RHI::Vulkan
             .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
             .pNext                  = nullptr,
             .flags                  = 0,
-            .setLayoutCount         = uint32_t(descriptorSetLayouts.size()),
-            .pSetLayouts            = descriptorSetLayouts.data(),
+            .setLayoutCount         = uint32_t(setLayouts.size()),
+            .pSetLayouts            = setLayouts.data(),
             .pushConstantRangeCount = uint32_t(pushConstantRanges.size()),
             .pPushConstantRanges    = pushConstantRanges.data(),
         };
@@ -975,7 +1529,56 @@ namespace RHI::Vulkan
     // IGraphicsPipeline
     ////////////////////////////////////////////////////////////////////////
 
-    VkPipelineShaderStageCreateInfo convertShaderStage(PipelineShaderStage stage)
+    // Owns the VkSpecializationInfo of every stage of one pipeline, the stage create infos point into it.
+    class ShaderStageSpecialization
+    {
+    public:
+        ShaderStageSpecialization(TL::Span<const PipelineShaderStage> stages)
+        {
+            size_t constantCount = 0;
+            for (const auto& stage : stages)
+                constantCount += stage.specializationConstants.size();
+
+            // Sized up front, so the pointers handed out below stay valid.
+            m_entries.resize(constantCount);
+            m_data.resize(constantCount);
+            m_infos.resize(stages.size());
+
+            uint32_t first = 0;
+            for (size_t i = 0; i < stages.size(); ++i)
+            {
+                auto constants = stages[i].specializationConstants;
+                for (uint32_t j = 0; j < constants.size(); ++j)
+                {
+                    TL_ASSERT(constants[j].size == 4 || constants[j].size == 8);
+                    m_entries[first + j] = {.constantID = constants[j].id, .offset = j * (uint32_t)sizeof(uint64_t), .size = constants[j].size};
+                    m_data[first + j]    = constants[j].value;
+                }
+                m_infos[i] = {
+                    .mapEntryCount = (uint32_t)constants.size(),
+                    .pMapEntries   = m_entries.data() + first,
+                    .dataSize      = constants.size() * sizeof(uint64_t),
+                    .pData         = m_data.data() + first,
+                };
+                first += (uint32_t)constants.size();
+            }
+        }
+
+        ShaderStageSpecialization(const ShaderStageSpecialization&) = delete;
+
+        const VkSpecializationInfo* Get(size_t stageIndex) const
+        {
+            return m_infos[stageIndex].mapEntryCount != 0 ? &m_infos[stageIndex] : nullptr;
+        }
+
+    private:
+        TL::Vector<VkSpecializationMapEntry> m_entries;
+        // One 8 byte slot per constant, 4 byte constants read the low half.
+        TL::Vector<uint64_t>                 m_data;
+        TL::Vector<VkSpecializationInfo>     m_infos;
+    };
+
+    VkPipelineShaderStageCreateInfo convertShaderStage(PipelineShaderStage stage, const VkSpecializationInfo* specializationInfo)
     {
         auto shaderModule = (IShaderModule*)stage.module;
 
@@ -986,20 +1589,120 @@ namespace RHI::Vulkan
             .stage               = ConvertShaderStage(stage.stage),
             .module              = shaderModule->m_shaderModule,
             .pName               = stage.name,
-            .pSpecializationInfo = nullptr,
+            .pSpecializationInfo = specializationInfo,
         };
     }
 
-    ResultCode IGraphicsPipeline::Init(IDevice* device, const GraphicsPipelineCreateInfo& createInfo)
+    // Tries the stages' module identifiers first, the driver then finds the pipeline in the pipeline cache without the
+    // SPIR-V and fails with VK_PIPELINE_COMPILE_REQUIRED on a miss, in which case it is created again from the modules.
+    template<typename CreateFn>
+    inline static VkResult createPipelineFromIdentifiers(IDevice* device, TL::Span<const PipelineShaderStage> stages, VkPipelineShaderStageCreateInfo* stageCIs, VkPipelineCreateFlags& flags, CreateFn&& create)
+    {
+        if (stages.empty() || !device->GetFeatures().hasShaderModuleIdentifier)
+            return create();
+
+        TL::Vector<VkPipelineShaderStageModuleIdentifierCreateInfoEXT> identifierCIs(stages.size());
+        for (size_t i = 0; i < stages.size(); ++i)
+        {
+            auto shaderModule = (IShaderModule*)stages[i].module;
+            identifierCIs[i]  = {
+                .sType          = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_MODULE_IDENTIFIER_CREATE_INFO_EXT,
+                .pNext          = nullptr,
+                .identifierSize = shaderModule->m_identifier.identifierSize,
+                .pIdentifier    = shaderModule->m_identifier.identifier,
+            };
+            stageCIs[i].pNext  = &identifierCIs[i];
+            stageCIs[i].module = VK_NULL_HANDLE;
+        }
+
+        flags |= VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT;
+        VkResult result = create();
+        flags &= ~VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT;
+
+        for (size_t i = 0; i < stages.size(); ++i)
+        {
+            stageCIs[i].pNext  = nullptr;
+            stageCIs[i].module = ((IShaderModule*)stages[i].module)->m_shaderModule;
+        }
+        return result == VK_PIPELINE_COMPILE_REQUIRED ? create() : result;
+    }
+
+    // Runs one vkCreate*Pipelines call for createInfo, a Vk*PipelineCreateInfo. Chains VkPipelineCreationFeedback to record
+    // the creation time and cache hit in the pipeline cache's stats, and shows both in a Tracy zone.
+    template<typename CreateInfo, typename CreateFn>
+    inline static VkResult createPipeline(IDevice* device, const TL::String& name, CreateInfo& createInfo, TL::Span<const PipelineShaderStage> stages, VkPipelineShaderStageCreateInfo* stageCIs, CreateFn&& create)
     {
-        TL::Vector<VkPipelineShaderStageCreateInfo> shaderStageCIs{device->m_arena};
-        for (const auto& stage : createInfo.shaderStages)
+        ZoneScopedN("Create pipeline");
+        ZoneText(name.c_str(), name.size());
+
+        VkPipelineCreationFeedback           feedback{};
+        VkPipelineCreationFeedbackCreateInfo feedbackCI{
+            .sType                              = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO,
+            .pNext                              = createInfo.pNext,
+            .pPipelineCreationFeedback          = &feedback,
+            .pipelineStageCreationFeedbackCount = 0,
+            .pPipelineStageCreationFeedbacks    = nullptr,
+        };
+        createInfo.pNext = &feedbackCI;
+
+        // Bind groups are read from the descriptor buffer instead of descriptor sets.
+        if (device->GetFeatures().hasDescriptorBuffer)
+            createInfo.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
+        auto     start    = std::chrono::steady_clock::now();
+        VkResult result   = createPipelineFromIdentifiers(device, stages, stageCIs, createInfo.flags, create);
+        auto     duration = std::chrono::steady_clock::now() - start;
+        createInfo.pNext  = feedbackCI.pNext;
+
+        if (result == VK_SUCCESS)
         {
-            shaderStageCIs.push_back(convertShaderStage(stage));
+            bool cacheHit = feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT;
+            ZoneText(cacheHit ? "Pipeline cache hit" : "Compiled", cacheHit ? 18 : 8);
+            device->m_pipelineCache.AddCreationStats(name, duration, feedback);
+        }
+        return result;
+    }
+
+    // Vulkan state of a GraphicsPipelineCreateInfo, shared by monolithic pipelines and pipeline library parts.
+    // The create infos point into the vectors, so the object is neither copied nor moved.
+    struct GraphicsPipelineState
+    {
+        GraphicsPipelineState(IDevice* device, const GraphicsPipelineCreateInfo& createInfo);
+        GraphicsPipelineState(const GraphicsPipelineState&) = delete;
+
+        // References only the state belonging to parts, a monolithic pipeline uses every part.
+        VkGraphicsPipelineCreateInfo GetCreateInfo(VkGraphicsPipelineLibraryFlagsEXT parts, const void* pNext);
+
+        // Pipelines may be created on the compiler's worker threads, so the arrays avoid device->m_arena.
+        ShaderStageSpecialization                       specialization;
+        TL::Vector<VkPipelineShaderStageCreateInfo>     shaderStageCIs;
+        TL::Vector<VkPipelineShaderStageCreateInfo>     partShaderStageCIs;
+        TL::Vector<VkVertexInputBindingDescription>     vertexBindings;
+        TL::Vector<VkVertexInputAttributeDescription>   vertexAttributes;
+        TL::Vector<VkFormat>                            colorAttachmentFormats;
+        TL::Vector<VkPipelineColorBlendAttachmentState> pipelineColorBlendAttachmentStates;
+        TL::Vector<VkDynamicState>                      dynamicStates;
+        VkPipelineVertexInputStateCreateInfo            vertexInputStateCI;
+        VkPipelineInputAssemblyStateCreateInfo          inputAssemblyStateCI;
+        VkPipelineTessellationStateCreateInfo           tessellationStateCI;
+        VkPipelineViewportStateCreateInfo               viewportStateCI;
+        VkPipelineRasterizationStateCreateInfo          rasterizationStateCI;
+        VkPipelineMultisampleStateCreateInfo            multisampleStateCI;
+        VkPipelineDepthStencilStateCreateInfo           depthStencilStateCI;
+        VkPipelineDynamicStateCreateInfo                dynamicStateCI;
+        VkPipelineColorBlendStateCreateInfo             colorBlendStateCI;
+        VkPipelineRenderingCreateInfo                   renderingCI;
+        VkPipelineLayout                                layout;
+    };
+
+    GraphicsPipelineState::GraphicsPipelineState(IDevice* device, const GraphicsPipelineCreateInfo& createInfo)
+        : specialization(createInfo.shaderStages)
+    {
+        for (size_t i = 0; i < createInfo.shaderStages.size(); ++i)
+        {
+            shaderStageCIs.push_back(convertShaderStage(createInfo.shaderStages[i], specialization.Get(i)));
         }
 
-        TL::Vector<VkVertexInputBindingDescription>   vertexBindings{device->m_arena};
-        TL::Vector<VkVertexInputAttributeDescription> vertexAttributes{device->m_arena};
         for (const auto& bindingDesc : createInfo.vertexBufferBindings)
         {
             VkVertexInputBindingDescription binding{
@@ -1020,7 +1723,7 @@ namespace RHI::Vulkan
             vertexBindings.push_back(binding);
         }
 
-        VkPipelineVertexInputStateCreateInfo vertexInputStateCI{
+        vertexInputStateCI = VkPipelineVertexInputStateCreateInfo{
             .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
             .pNext                           = nullptr,
             .flags                           = 0,
@@ -1030,7 +1733,7 @@ namespace RHI::Vulkan
             .pVertexAttributeDescriptions    = vertexAttributes.data(),
         };
 
-        VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateCI{
+        inputAssemblyStateCI = VkPipelineInputAssemblyStateCreateInfo{
             .sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
             .pNext                  = nullptr,
             .flags                  = 0,
@@ -1038,24 +1741,24 @@ namespace RHI::Vulkan
             .primitiveRestartEnable = VK_FALSE,
         };
 
-        VkPipelineTessellationStateCreateInfo tessellationStateCI{
+        tessellationStateCI = VkPipelineTessellationStateCreateInfo{
             .sType              = VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO,
             .pNext              = nullptr,
             .flags              = 0,
             .patchControlPoints = 0,
         };
 
-        VkPipelineViewportStateCreateInfo viewportStateCI{
+        viewportStateCI = VkPipelineViewportStateCreateInfo{
             .sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
             .pNext         = nullptr,
             .flags         = 0,
-            .viewportCount = 1,
+            .viewportCount = 0,
             .pViewports    = nullptr,
-            .scissorCount  = 1,
+            .scissorCount  = 0,
             .pScissors     = nullptr,
         };
 
-        VkPipelineRasterizationStateCreateInfo rasterizationStateCI{
+        rasterizationStateCI = VkPipelineRasterizationStateCreateInfo{
             .sType                   = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
             .pNext                   = nullptr,
             .flags                   = 0,
@@ -1071,134 +1774,447 @@ namespace RHI::Vulkan
             .lineWidth               = createInfo.rasterizationState.lineWidth,
         };
 
-        VkPipelineMultisampleStateCreateInfo multisampleStateCI{
-            .sType                 = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
-            .pNext                 = nullptr,
-            .flags                 = 0,
-            .rasterizationSamples  = ConvertSampleCount(createInfo.multisampleState.sampleCount),
-            .sampleShadingEnable   = ConvertBool(createInfo.multisampleState.sampleShading),
-            .minSampleShading      = 1.0f,
-            .pSampleMask           = nullptr,
-            .alphaToCoverageEnable = VK_FALSE,
-            .alphaToOneEnable      = VK_FALSE,
-        };
+        multisampleStateCI = VkPipelineMultisampleStateCreateInfo{
+            .sType                 = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+            .pNext                 = nullptr,
+            .flags                 = 0,
+            .rasterizationSamples  = ConvertSampleCount(createInfo.multisampleState.sampleCount),
+            .sampleShadingEnable   = ConvertBool(createInfo.multisampleState.sampleShading),
+            .minSampleShading      = 1.0f,
+            .pSampleMask           = nullptr,
+            .alphaToCoverageEnable = VK_FALSE,
+            .alphaToOneEnable      = VK_FALSE,
+        };
+
+        depthStencilStateCI = VkPipelineDepthStencilStateCreateInfo{
+            .sType                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+            .pNext                 = nullptr,
+            .flags                 = 0,
+            .depthTestEnable       = ConvertBool(createInfo.depthStencilState.depthTestEnable),
+            .depthWriteEnable      = ConvertBool(createInfo.depthStencilState.depthWriteEnable),
+            .depthCompareOp        = ConvertCompareOp(createInfo.depthStencilState.compareOperator),
+            .depthBoundsTestEnable = VK_FALSE,
+            .stencilTestEnable     = ConvertBool(createInfo.depthStencilState.stencilTestEnable),
+            .front                 = ConvertStencilOpState(createInfo.depthStencilState),
+            .back                  = ConvertStencilOpState(createInfo.depthStencilState),
+            .minDepthBounds        = 0.0,
+            .maxDepthBounds        = 1.0,
+        };
+
+        // The counts are dynamic too, so SetViewport and SetScissor record the same commands for shader objects.
+        dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT_WITH_COUNT, VK_DYNAMIC_STATE_SCISSOR_WITH_COUNT};
+        if (createInfo.dynamicState)
+        {
+            dynamicStates.push_back(VK_DYNAMIC_STATE_CULL_MODE);
+            dynamicStates.push_back(VK_DYNAMIC_STATE_FRONT_FACE);
+            dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE);
+            dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE);
+            dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP);
+            dynamicStates.push_back(VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE);
+            if (device->GetFeatures().hasDynamicColorBlendEnable)
+                dynamicStates.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+        }
+
+        dynamicStateCI = VkPipelineDynamicStateCreateInfo{
+            .sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+            .pNext             = nullptr,
+            .flags             = 0,
+            .dynamicStateCount = (uint32_t)dynamicStates.size(),
+            .pDynamicStates    = dynamicStates.data(),
+        };
+
+        colorAttachmentFormats.reserve(createInfo.renderTargetLayout.colors.size());
+        for (auto format : createInfo.renderTargetLayout.colors)
+        {
+            colorAttachmentFormats.push_back(ConvertFormat(format));
+        }
+
+        pipelineColorBlendAttachmentStates.reserve(colorAttachmentFormats.size());
+
+        for (auto blendState : createInfo.colorBlendState.blendStates)
+        {
+            VkPipelineColorBlendAttachmentState state{
+                .blendEnable         = blendState.blendEnable ? VK_TRUE : VK_FALSE,
+                .srcColorBlendFactor = ConvertBlendFactor(blendState.srcColor),
+                .dstColorBlendFactor = ConvertBlendFactor(blendState.dstColor),
+                .colorBlendOp        = ConvertBlendOp(blendState.colorBlendOp),
+                .srcAlphaBlendFactor = ConvertBlendFactor(blendState.srcAlpha),
+                .dstAlphaBlendFactor = ConvertBlendFactor(blendState.dstAlpha),
+                .alphaBlendOp        = ConvertBlendOp(blendState.alphaBlendOp),
+                .colorWriteMask      = ConvertColorWriteMask(blendState.writeMask),
+            };
+            pipelineColorBlendAttachmentStates.push_back(state);
+        }
+
+        auto [r, g, b, a] = createInfo.colorBlendState.blendConstants;
+        colorBlendStateCI = VkPipelineColorBlendStateCreateInfo{
+            .sType           = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+            .pNext           = nullptr,
+            .flags           = 0,
+            .logicOpEnable   = VK_FALSE,
+            .logicOp         = VK_LOGIC_OP_SET,
+            .attachmentCount = (uint32_t)colorAttachmentFormats.size(),
+            .pAttachments    = pipelineColorBlendAttachmentStates.data(),
+            .blendConstants  = {r, g, b, a},
+        };
+
+        renderingCI = VkPipelineRenderingCreateInfo{
+            .sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+            .pNext                   = nullptr,
+            .viewMask                = 0,
+            .colorAttachmentCount    = (uint32_t)colorAttachmentFormats.size(),
+            .pColorAttachmentFormats = colorAttachmentFormats.data(),
+            .depthAttachmentFormat   = ConvertFormat(createInfo.renderTargetLayout.depth),
+            .stencilAttachmentFormat = ConvertFormat(createInfo.renderTargetLayout.stencil),
+        };
+
+        layout = ((IPipelineLayout*)createInfo.layout)->handle;
+    }
+
+    VkGraphicsPipelineCreateInfo GraphicsPipelineState::GetCreateInfo(VkGraphicsPipelineLibraryFlagsEXT parts, const void* pNext)
+    {
+        bool vertexInput      = parts & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+        bool preRasterization = parts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+        bool fragmentShader   = parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+        bool fragmentOutput   = parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+        partShaderStageCIs.clear();
+        for (const auto& stageCI : shaderStageCIs)
+        {
+            bool isFragment = stageCI.stage == VK_SHADER_STAGE_FRAGMENT_BIT;
+            if ((isFragment && fragmentShader) || (!isFragment && preRasterization))
+                partShaderStageCIs.push_back(stageCI);
+        }
+
+        renderingCI.pNext = pNext;
+        return {
+            .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            .pNext               = &renderingCI,
+            .flags               = 0,
+            .stageCount          = (uint32_t)partShaderStageCIs.size(),
+            .pStages             = partShaderStageCIs.data(),
+            .pVertexInputState   = vertexInput ? &vertexInputStateCI : nullptr,
+            .pInputAssemblyState = vertexInput ? &inputAssemblyStateCI : nullptr,
+            .pTessellationState  = preRasterization ? &tessellationStateCI : nullptr,
+            .pViewportState      = preRasterization ? &viewportStateCI : nullptr,
+            .pRasterizationState = preRasterization ? &rasterizationStateCI : nullptr,
+            .pMultisampleState   = fragmentShader || fragmentOutput ? &multisampleStateCI : nullptr,
+            .pDepthStencilState  = fragmentShader ? &depthStencilStateCI : nullptr,
+            .pColorBlendState    = fragmentOutput ? &colorBlendStateCI : nullptr,
+            .pDynamicState       = &dynamicStateCI,
+            .layout              = preRasterization || fragmentShader ? layout : VK_NULL_HANDLE,
+            .renderPass          = VK_NULL_HANDLE,
+            .subpass             = 0,
+            .basePipelineHandle  = VK_NULL_HANDLE,
+            .basePipelineIndex   = 0,
+        };
+    }
+
+    constexpr VkGraphicsPipelineLibraryFlagsEXT AllGraphicsPipelineLibraryParts =
+        VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT |
+        VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT |
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT |
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+    inline static VkGraphicsPipelineLibraryFlagsEXT ConvertGraphicsPipelineLibraryParts(TL::Flags<GraphicsPipelineLibraryPart> parts)
+    {
+        VkGraphicsPipelineLibraryFlagsEXT result = 0;
+        if (parts & GraphicsPipelineLibraryPart::VertexInput) result |= VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+        if (parts & GraphicsPipelineLibraryPart::PreRasterization) result |= VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+        if (parts & GraphicsPipelineLibraryPart::FragmentShader) result |= VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+        if (parts & GraphicsPipelineLibraryPart::FragmentOutput) result |= VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+        return result;
+    }
+
+    void GraphicsPipelineDynamicState::Init(const GraphicsPipelineCreateInfo& createInfo, TL::Flags<GraphicsPipelineLibraryPart> parts)
+    {
+        enabled = createInfo.dynamicState;
+        if (parts & GraphicsPipelineLibraryPart::PreRasterization)
+        {
+            cullMode  = createInfo.rasterizationState.cullMode;
+            frontFace = createInfo.rasterizationState.frontFace;
+        }
+        if (parts & GraphicsPipelineLibraryPart::FragmentShader)
+        {
+            depthStencilState = createInfo.depthStencilState;
+        }
+        if (parts & GraphicsPipelineLibraryPart::FragmentOutput)
+        {
+            TL_ASSERT(createInfo.colorBlendState.blendStates.size() <= MaxColorAttachments);
+            colorAttachmentCount = (uint32_t)createInfo.colorBlendState.blendStates.size();
+            for (uint32_t i = 0; i < colorAttachmentCount; ++i)
+                blendEnables[i] = createInfo.colorBlendState.blendStates[i].blendEnable;
+        }
+    }
+
+    void GraphicsPipelineDynamicState::Merge(const GraphicsPipelineDynamicState& other, TL::Flags<GraphicsPipelineLibraryPart> parts)
+    {
+        enabled |= other.enabled;
+        if (parts & GraphicsPipelineLibraryPart::PreRasterization)
+        {
+            cullMode  = other.cullMode;
+            frontFace = other.frontFace;
+        }
+        if (parts & GraphicsPipelineLibraryPart::FragmentShader)
+        {
+            depthStencilState = other.depthStencilState;
+        }
+        if (parts & GraphicsPipelineLibraryPart::FragmentOutput)
+        {
+            colorAttachmentCount = other.colorAttachmentCount;
+            std::copy_n(other.blendEnables, MaxColorAttachments, blendEnables);
+        }
+    }
+
+    ResultCode IGraphicsPipeline::Init(IDevice* device, const GraphicsPipelineCreateInfo& createInfo)
+    {
+        this->layout = (IPipelineLayout*)createInfo.layout;
+        dynamicState.Init(createInfo, GraphicsPipelineLibraryPart::All);
+
+        GraphicsPipelineState        state(device, createInfo);
+        VkGraphicsPipelineCreateInfo graphicsPipelineCI = state.GetCreateInfo(AllGraphicsPipelineLibraryParts, nullptr);
+
+        // pStages points at the part copy, which holds every stage in order for a monolithic pipeline.
+        VulkanResult result = createPipeline(device, getName(), graphicsPipelineCI, createInfo.shaderStages, state.partShaderStageCIs.data(), [&]()
+            {
+                return vkCreateGraphicsPipelines(device->m_device, device->m_pipelineCache.GetHandle(), 1, &graphicsPipelineCI, nullptr, &handle);
+            });
+        TL_ASSERT(result, "vkCreateGraphicsPipelines failed with error: {}", result.AsString());
+        if (result && !getName().empty())
+        {
+            device->SetDebugName(handle, getName().c_str());
+        }
+        return result;
+    }
+
+    ResultCode IGraphicsPipeline::Link(IDevice* device, const GraphicsPipelineLinkInfo& linkInfo, bool optimize)
+    {
+        // The optimized link runs while the pipeline may already be bound, its layout and state were set by the fast link.
+        auto linkLayout = (IPipelineLayout*)linkInfo.layout;
+        if (!optimize)
+            this->layout = linkLayout;
+
+        TL::Vector<VkPipeline> libraries;
+        for (auto _library : linkInfo.libraries)
+        {
+            auto library = (IGraphicsPipelineLibrary*)_library;
+            libraries.push_back(library->handle);
+            if (!optimize)
+                dynamicState.Merge(library->dynamicState, library->parts);
+        }
+
+        VkPipelineLibraryCreateInfoKHR libraryCI{
+            .sType        = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+            .pNext        = nullptr,
+            .libraryCount = (uint32_t)libraries.size(),
+            .pLibraries   = libraries.data(),
+        };
+        VkGraphicsPipelineCreateInfo graphicsPipelineCI{
+            .sType  = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            .pNext  = &libraryCI,
+            .flags  = optimize ? VkPipelineCreateFlags(VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT) : 0,
+            .layout = linkLayout->handle,
+        };
+
+        VkPipeline   linked = VK_NULL_HANDLE;
+        VulkanResult result = createPipeline(device, optimize ? TL::fmt("{} (optimized)", getName()) : getName(), graphicsPipelineCI, {}, nullptr, [&]()
+            {
+                return vkCreateGraphicsPipelines(device->m_device, device->m_pipelineCache.GetHandle(), 1, &graphicsPipelineCI, nullptr, &linked);
+            });
+        if (!result)
+        {
+            TL::LogError("Failed to link graphics pipeline {}: {}", getName(), result.AsString());
+            return result;
+        }
+
+        if (!getName().empty())
+            device->SetDebugName(linked, "{}{}", getName(), optimize ? " (optimized)" : "");
+
+        if (optimize)
+            optimizedHandle.store(linked, std::memory_order_release);
+        else
+            handle = linked;
+        return ResultCode::Success;
+    }
+
+    void IGraphicsPipeline::Shutdown(IDevice* device)
+    {
+        auto frame = device->GetLastSubmitValues();
+
+        if (handle)
+            device->m_destroyQueue->Push(frame, handle);
+        if (auto optimized = optimizedHandle.load())
+            device->m_destroyQueue->Push(frame, optimized);
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // IGraphicsPipelineLibrary
+    ////////////////////////////////////////////////////////////////////////
+
+    ResultCode IGraphicsPipelineLibrary::Init(IDevice* device, const GraphicsPipelineLibraryCreateInfo& createInfo)
+    {
+        this->parts = createInfo.parts;
+        dynamicState.Init(createInfo.state, createInfo.parts);
+
+        GraphicsPipelineState                  state(device, createInfo.state);
+        VkGraphicsPipelineLibraryCreateInfoEXT libraryCI{
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+            .pNext = nullptr,
+            .flags = ConvertGraphicsPipelineLibraryParts(createInfo.parts),
+        };
+        VkGraphicsPipelineCreateInfo graphicsPipelineCI = state.GetCreateInfo(libraryCI.flags, &libraryCI);
+        // Retaining the link time optimization info allows optimized links later on.
+        graphicsPipelineCI.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+
+        VulkanResult result = createPipeline(device, getName(), graphicsPipelineCI, {}, nullptr, [&]()
+            {
+                return vkCreateGraphicsPipelines(device->m_device, device->m_pipelineCache.GetHandle(), 1, &graphicsPipelineCI, nullptr, &handle);
+            });
+        if (result && !getName().empty())
+            device->SetDebugName(handle, getName().c_str());
+        return result;
+    }
+
+    void IGraphicsPipelineLibrary::Shutdown(IDevice* device)
+    {
+        auto frame = device->GetLastSubmitValues();
+
+        if (handle)
+            device->m_destroyQueue->Push(frame, handle);
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // IShaderObject
+    ////////////////////////////////////////////////////////////////////////
 
-        VkPipelineDepthStencilStateCreateInfo depthStencilStateCI{
-            .sType                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
-            .pNext                 = nullptr,
-            .flags                 = 0,
-            .depthTestEnable       = ConvertBool(createInfo.depthStencilState.depthTestEnable),
-            .depthWriteEnable      = ConvertBool(createInfo.depthStencilState.depthWriteEnable),
-            .depthCompareOp        = ConvertCompareOp(createInfo.depthStencilState.compareOperator),
-            .depthBoundsTestEnable = VK_FALSE,
-            .stencilTestEnable     = ConvertBool(createInfo.depthStencilState.stencilTestEnable),
-            .front                 = {},
-            .back                  = {},
-            .minDepthBounds        = 0.0,
-            .maxDepthBounds        = 1.0,
-        };
+    ResultCode IShaderObject::Init(IDevice* device, const ShaderObjectCreateInfo& createInfo)
+    {
+        TL_ASSERT(createInfo.shaderStages.size() <= MaxStages);
 
-        VkDynamicState                   dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
-        VkPipelineDynamicStateCreateInfo dynamicStateCI{
-            .sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-            .pNext             = nullptr,
-            .flags             = 0,
-            .dynamicStateCount = sizeof(dynamicStates) / sizeof(VkDynamicState),
-            .pDynamicStates    = dynamicStates,
-        };
+        this->layout     = (IPipelineLayout*)createInfo.layout;
+        this->stageCount = (uint32_t)createInfo.shaderStages.size();
 
-        TL::Vector<VkFormat> colorAttachmentFormats{device->m_arena};
-        colorAttachmentFormats.reserve(createInfo.renderTargetLayout.colors.size());
-        for (auto format : createInfo.renderTargetLayout.colors)
+        bool hasTaskShader = std::any_of(createInfo.shaderStages.begin(), createInfo.shaderStages.end(), [](const PipelineShaderStage& stage)
+            {
+                return stage.stage == ShaderStage::Amplification;
+            });
+
+        ShaderStageSpecialization         specialization(createInfo.shaderStages);
+        TL::Vector<VkShaderCreateInfoEXT> shaderCIs;
+        for (uint32_t i = 0; i < stageCount; ++i)
         {
-            colorAttachmentFormats.push_back(ConvertFormat(format));
+            const auto& stage        = createInfo.shaderStages[i];
+            auto        shaderModule = (IShaderModule*)stage.module;
+            stages[i]                = ConvertShaderStage(stage.stage);
+
+            VkShaderCreateFlagsEXT flags     = stageCount > 1 ? VK_SHADER_CREATE_LINK_STAGE_BIT_EXT : 0;
+            VkShaderStageFlags     nextStage = 0;
+            switch (stages[i])
+            {
+            case VK_SHADER_STAGE_VERTEX_BIT:  nextStage = VK_SHADER_STAGE_FRAGMENT_BIT; break;
+            case VK_SHADER_STAGE_TASK_BIT_EXT: nextStage = VK_SHADER_STAGE_MESH_BIT_EXT; break;
+            case VK_SHADER_STAGE_MESH_BIT_EXT:
+                nextStage = VK_SHADER_STAGE_FRAGMENT_BIT;
+                if (!hasTaskShader) flags |= VK_SHADER_CREATE_NO_TASK_SHADER_BIT_EXT;
+                break;
+            case VK_SHADER_STAGE_FRAGMENT_BIT:
+            case VK_SHADER_STAGE_COMPUTE_BIT: break;
+            default:
+                TL_UNREACHABLE_MSG("Shader objects do not support this stage");
+                return ResultCode::ErrorInvalidArguments;
+            }
+
+            shaderCIs.push_back({
+                .sType                  = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT,
+                .pNext                  = nullptr,
+                .flags                  = flags,
+                .stage                  = stages[i],
+                .nextStage              = nextStage,
+                .codeType               = VK_SHADER_CODE_TYPE_SPIRV_EXT,
+                .codeSize               = shaderModule->m_code.size() * sizeof(uint32_t),
+                .pCode                  = shaderModule->m_code.data(),
+                .pName                  = stage.name,
+                .setLayoutCount         = (uint32_t)layout->setLayouts.size(),
+                .pSetLayouts            = layout->setLayouts.data(),
+                .pushConstantRangeCount = (uint32_t)layout->pushConstantRanges.size(),
+                .pPushConstantRanges    = layout->pushConstantRanges.data(),
+                .pSpecializationInfo    = specialization.Get(i),
+            });
         }
 
-        TL::Vector<VkPipelineColorBlendAttachmentState> pipelineColorBlendAttachmentStates{device->m_arena};
-        pipelineColorBlendAttachmentStates.reserve(colorAttachmentFormats.size());
+        VulkanResult result = vkCreateShadersEXT(device->m_device, stageCount, shaderCIs.data(), nullptr, shaders);
+        if (!result)
+            return result;
 
-        for (auto blendState : createInfo.colorBlendState.blendStates)
+        if (!getName().empty())
         {
-            VkPipelineColorBlendAttachmentState state{
-                .blendEnable         = blendState.blendEnable ? VK_TRUE : VK_FALSE,
+            for (uint32_t i = 0; i < stageCount; ++i)
+                device->SetDebugName(shaders[i], "{} [{}]", getName(), i);
+        }
+
+        for (const auto& bindingDesc : createInfo.vertexBufferBindings)
+        {
+            uint32_t binding = (uint32_t)vertexBindings.size();
+            for (const auto& attributeDesc : bindingDesc.attributes)
+            {
+                vertexAttributes.push_back({
+                    .sType    = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT,
+                    .pNext    = nullptr,
+                    .location = (uint32_t)vertexAttributes.size(),
+                    .binding  = binding,
+                    .format   = ConvertFormat(attributeDesc.format),
+                    .offset   = attributeDesc.offset,
+                });
+            }
+            vertexBindings.push_back({
+                .sType     = VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT,
+                .pNext     = nullptr,
+                .binding   = binding,
+                .stride    = bindingDesc.stride,
+                .inputRate = ConvertVertexInputRate(bindingDesc.stepRate),
+                .divisor   = 1,
+            });
+        }
+
+        for (const auto& blendState : createInfo.colorBlendState.blendStates)
+        {
+            blendEquations.push_back({
                 .srcColorBlendFactor = ConvertBlendFactor(blendState.srcColor),
                 .dstColorBlendFactor = ConvertBlendFactor(blendState.dstColor),
                 .colorBlendOp        = ConvertBlendOp(blendState.colorBlendOp),
                 .srcAlphaBlendFactor = ConvertBlendFactor(blendState.srcAlpha),
                 .dstAlphaBlendFactor = ConvertBlendFactor(blendState.dstAlpha),
                 .alphaBlendOp        = ConvertBlendOp(blendState.alphaBlendOp),
-                .colorWriteMask      = 0,
-            };
-            if (blendState.writeMask & ColorWriteMask::Red) state.colorWriteMask |= VK_COLOR_COMPONENT_R_BIT;
-            if (blendState.writeMask & ColorWriteMask::Green) state.colorWriteMask |= VK_COLOR_COMPONENT_G_BIT;
-            if (blendState.writeMask & ColorWriteMask::Blue) state.colorWriteMask |= VK_COLOR_COMPONENT_B_BIT;
-            if (blendState.writeMask & ColorWriteMask::Alpha) state.colorWriteMask |= VK_COLOR_COMPONENT_A_BIT;
-
-            pipelineColorBlendAttachmentStates.push_back(state);
+            });
+            writeMasks.push_back(ConvertColorWriteMask(blendState.writeMask));
         }
+        stencilState = ConvertStencilOpState(createInfo.depthStencilState);
 
-        auto [r, g, b, a] = createInfo.colorBlendState.blendConstants;
-        VkPipelineColorBlendStateCreateInfo colorBlendStateCI{
-            .sType           = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
-            .pNext           = nullptr,
-            .flags           = 0,
-            .logicOpEnable   = VK_FALSE,
-            .logicOp         = VK_LOGIC_OP_SET,
-            .attachmentCount = (uint32_t)colorAttachmentFormats.size(),
-            .pAttachments    = pipelineColorBlendAttachmentStates.data(),
-            .blendConstants  = {r, g, b, a},
-        };
-
-        VkPipelineRenderingCreateInfo renderTargetLayout{
-            .sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
-            .pNext                   = nullptr,
-            .viewMask                = 0,
-            .colorAttachmentCount    = (uint32_t)colorAttachmentFormats.size(),
-            .pColorAttachmentFormats = colorAttachmentFormats.data(),
-            .depthAttachmentFormat   = ConvertFormat(createInfo.renderTargetLayout.depth),
-            .stencilAttachmentFormat = ConvertFormat(createInfo.renderTargetLayout.stencil),
-        };
-
-        this->layout = (IPipelineLayout*)createInfo.layout;
-
-        VkGraphicsPipelineCreateInfo graphicsPipelineCI{
-            .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-            .pNext               = &renderTargetLayout,
-            .flags               = 0,
-            .stageCount          = (uint32_t)shaderStageCIs.size(),
-            .pStages             = shaderStageCIs.data(),
-            .pVertexInputState   = &vertexInputStateCI,
-            .pInputAssemblyState = &inputAssemblyStateCI,
-            .pTessellationState  = &tessellationStateCI,
-            .pViewportState      = &viewportStateCI,
-            .pRasterizationState = &rasterizationStateCI,
-            .pMultisampleState   = &multisampleStateCI,
-            .pDepthStencilState  = &depthStencilStateCI,
-            .pColorBlendState    = &colorBlendStateCI,
-            .pDynamicState       = &dynamicStateCI,
-            .layout              = this->layout->handle,
-            .renderPass          = VK_NULL_HANDLE,
-            .subpass             = 0,
-            .basePipelineHandle  = VK_NULL_HANDLE,
-            .basePipelineIndex   = 0,
+        GraphicsPipelineCreateInfo pipelineState{
+            .colorBlendState    = createInfo.colorBlendState,
+            .rasterizationState = createInfo.rasterizationState,
+            .depthStencilState  = createInfo.depthStencilState,
+            .dynamicState       = true,
         };
+        dynamicState.Init(pipelineState, GraphicsPipelineLibraryPart::All);
 
-        VulkanResult result;
-        result = vkCreateGraphicsPipelines(device->m_device, VK_NULL_HANDLE, 1, &graphicsPipelineCI, nullptr, &handle);
-        TL_ASSERT(result, "vkCreateGraphicsPipelines failed with error: {}", result.AsString());
-        if (result && !getName().empty())
-        {
-            device->SetDebugName(handle, getName().c_str());
-        }
-        return result;
+        topology    = ConvertPrimitiveTopology(createInfo.topologyMode);
+        polygonMode = ConvertPolygonMode(createInfo.rasterizationState.fillMode);
+        lineWidth   = createInfo.rasterizationState.lineWidth;
+        sampleCount = ConvertSampleCount(createInfo.multisampleState.sampleCount);
+        std::copy_n(createInfo.colorBlendState.blendConstants, 4, blendConstants);
+        return ResultCode::Success;
     }
 
-    void IGraphicsPipeline::Shutdown(IDevice* device)
+    void IShaderObject::Shutdown(IDevice* device)
     {
-        auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+        auto frame = device->GetLastSubmitValues();
 
-        if (handle)
-            device->m_destroyQueue->Push(frame, handle);
+        for (uint32_t i = 0; i < stageCount; ++i)
+        {
+            if (shaders[i])
+                device->m_destroyQueue->Push(frame, shaders[i]);
+        }
     }
 
     ////////////////////////////////////////////////////////////////////////
@@ -1207,8 +2223,10 @@ namespace RHI::Vulkan
 
     ResultCode IComputePipeline::Init(IDevice* device, const ComputePipelineCreateInfo& createInfo)
     {
-        this->layout     = (IPipelineLayout*)createInfo.layout;
-        auto shaderStage = convertShaderStage(createInfo.computeShader);
+        this->layout = (IPipelineLayout*)createInfo.layout;
+
+        ShaderStageSpecialization specialization(TL::Span<const PipelineShaderStage>(&createInfo.computeShader, 1));
+        auto                      shaderStage = convertShaderStage(createInfo.computeShader, specialization.Get(0));
 
         VkComputePipelineCreateInfo computePipelineCI{
             .sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
@@ -1220,7 +2238,10 @@ namespace RHI::Vulkan
             .basePipelineIndex  = 0,
         };
 
-        VulkanResult result = vkCreateComputePipelines(device->m_device, VK_NULL_HANDLE, 1, &computePipelineCI, nullptr, &handle);
+        VulkanResult result = createPipeline(device, getName(), computePipelineCI, TL::Span<const PipelineShaderStage>(&createInfo.computeShader, 1), &computePipelineCI.stage, [&]()
+            {
+                return vkCreateComputePipelines(device->m_device, device->m_pipelineCache.GetHandle(), 1, &computePipelineCI, nullptr, &handle);
+            });
         if (result == VK_SUCCESS && !getName().empty())
             device->SetDebugName(handle, getName().c_str());
         return result;
@@ -1228,7 +2249,7 @@ namespace RHI::Vulkan
 
     void IComputePipeline::Shutdown(IDevice* device)
     {
-        auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+        auto frame = device->GetLastSubmitValues();
 
         if (handle)
             device->m_destroyQueue->Push(frame, handle);
@@ -1253,14 +2274,15 @@ namespace RHI::Vulkan
     {
         this->layout = (IPipelineLayout*)createInfo.layout;
 
-        TL::Vector<VkPipelineShaderStageCreateInfo> shaderStagesCI{device->m_arena};
+        ShaderStageSpecialization                   specialization(createInfo.shaderStages);
+        TL::Vector<VkPipelineShaderStageCreateInfo> shaderStagesCI;
         shaderStagesCI.reserve(createInfo.shaderStages.size());
-        for (const auto& stage : createInfo.shaderStages)
+        for (size_t i = 0; i < createInfo.shaderStages.size(); ++i)
         {
-            shaderStagesCI.push_back(convertShaderStage(stage));
+            shaderStagesCI.push_back(convertShaderStage(createInfo.shaderStages[i], specialization.Get(i)));
         }
 
-        TL::Vector<VkRayTracingShaderGroupCreateInfoKHR> shaderGroupsCI{device->m_arena};
+        TL::Vector<VkRayTracingShaderGroupCreateInfoKHR> shaderGroupsCI;
         shaderGroupsCI.reserve(createInfo.shaderGroups.size());
         for (const auto& groupInfo : createInfo.shaderGroups)
         {
@@ -1293,7 +2315,10 @@ namespace RHI::Vulkan
             .basePipelineIndex            = 0,
         };
 
-        VulkanResult result = vkCreateRayTracingPipelinesKHR(device->m_device, VK_NULL_HANDLE, VK_NULL_HANDLE, 1, &pipelineCI, nullptr, &handle);
+        VulkanResult result = createPipeline(device, getName(), pipelineCI, createInfo.shaderStages, shaderStagesCI.data(), [&]()
+            {
+                return vkCreateRayTracingPipelinesKHR(device->m_device, VK_NULL_HANDLE, device->m_pipelineCache.GetHandle(), 1, &pipelineCI, nullptr, &handle);
+            });
         if (result != VK_SUCCESS) return result;
 
         if (!getName().empty())
@@ -1304,7 +2329,7 @@ namespace RHI::Vulkan
 
     void IRayTracingPipeline::Shutdown(IDevice* device)
     {
-        auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+        auto frame = device->GetLastSubmitValues();
 
         if (handle)
             device->m_destroyQueue->Push(frame, handle);
@@ -1357,7 +2382,7 @@ namespace RHI::Vulkan
 
     void IQueryPool::Shutdown(IDevice* device)
     {
-        auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+        auto frame = device->GetLastSubmitValues();
 
         if (handle)
             device->m_destroyQueue->Push(frame, handle);
@@ -1367,44 +2392,77 @@ namespace RHI::Vulkan
     // IBuffer
     ////////////////////////////////////////////////////////////////////////
 
-    ResultCode IBuffer::Init(IDevice* device, const BufferCreateInfo& createInfo)
+    inline static VkBufferCreateInfo GetBufferCreateInfo(IDevice* device, const BufferCreateInfo& createInfo)
     {
-        VmaAllocationCreateFlags allocationFlags = 0;
-        VkMemoryPropertyFlags    requiredFlags   = 0;
-        if (createInfo.usageFlags & BufferUsage::HostMapped)
-        {
-            allocationFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
-            requiredFlags   = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
-        }
+        VkBufferUsageFlags usageFlags = ConvertBufferUsageFlags(createInfo.usageFlags);
+        // Buffer descriptors are built from device addresses on the descriptor buffer path.
+        if (device->GetFeatures().hasDescriptorBuffer && (usageFlags & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)))
+            usageFlags |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
 
-        VmaAllocationCreateInfo allocationCI{
-            .flags          = allocationFlags,
-            .usage          = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
-            .requiredFlags  = requiredFlags,
-            .preferredFlags = 0,
-            .memoryTypeBits = 0,
-            .pool           = VK_NULL_HANDLE,
-            .pUserData      = nullptr,
-            .priority       = 0.0f,
-        };
-        VkBufferCreateInfo bufferCI{
+        return {
             .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
             .pNext                 = nullptr,
             .flags                 = 0,
             .size                  = createInfo.byteSize,
-            .usage                 = ConvertBufferUsageFlags(createInfo.usageFlags),
+            .usage                 = usageFlags,
             .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
             .queueFamilyIndexCount = 0,
             .pQueueFamilyIndices   = nullptr,
         };
-        VulkanResult result = vmaCreateBuffer(device->m_deviceAllocator, &bufferCI, &allocationCI, &handle, &allocation, nullptr);
-        if (result != VK_SUCCESS)
-            return result;
+    }
+
+    ResultCode IBuffer::Init(IDevice* device, const BufferCreateInfo& createInfo, const MemoryPlacement* placement)
+    {
+        VkBufferCreateInfo bufferCI = GetBufferCreateInfo(device, createInfo);
+        VulkanResult       result;
+
+        size = createInfo.byteSize;
+
+        if (placement)
+        {
+            TL_ASSERT(!(createInfo.usageFlags & BufferUsage::HostMapped), "Aliased buffers can't be host mapped");
+
+            // The memory belongs to the placement's owner.
+            allocation = VK_NULL_HANDLE;
+            result     = vmaCreateAliasingBuffer2(device->m_deviceAllocator, placement->allocation, placement->offset, &bufferCI, &handle);
+            if (result != VK_SUCCESS)
+                return result;
+        }
+        else
+        {
+            VmaAllocationCreateFlags allocationFlags = 0;
+            VkMemoryPropertyFlags    requiredFlags   = 0;
+            if (createInfo.usageFlags & BufferUsage::HostMapped)
+            {
+                // Mapped once at creation, Map only offsets into the persistent pointer. Coherent, writes through
+                // Device::AllocateDynamic pointers are never flushed.
+                allocationFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+                requiredFlags   = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            }
+
+            VmaAllocationCreateInfo allocationCI{
+                .flags          = allocationFlags,
+                .usage          = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+                .requiredFlags  = requiredFlags,
+                .preferredFlags = 0,
+                .memoryTypeBits = 0,
+                .pool           = VK_NULL_HANDLE,
+                .pUserData      = nullptr,
+                .priority       = 0.0f,
+            };
+            VmaAllocationInfo allocationInfo{};
+            result = vmaCreateBuffer(device->m_deviceAllocator, &bufferCI, &allocationCI, &handle, &allocation, &allocationInfo);
+            if (result != VK_SUCCESS)
+                return result;
+
+            mappedPtr = allocationInfo.pMappedData;
+        }
 
         if (!getName().empty())
         {
             device->SetDebugName(handle, getName().c_str());
-            vmaSetAllocationName(device->m_deviceAllocator, allocation, getName().c_str());
+            if (allocation)
+                vmaSetAllocationName(device->m_deviceAllocator, allocation, getName().c_str());
         }
 
         if (bufferCI.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
@@ -1422,7 +2480,7 @@ namespace RHI::Vulkan
 
     void IBuffer::Shutdown(IDevice* device)
     {
-        auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+        auto frame = device->GetLastSubmitValues();
 
         if (handle)
             device->m_destroyQueue->Push(frame, handle);
@@ -1431,41 +2489,25 @@ namespace RHI::Vulkan
             device->m_destroyQueue->Push(frame, allocation);
     }
 
-    DeviceMemoryPtr IBuffer::Map(IDevice* device)
+    DeviceMemoryPtr IBuffer::Map(IDevice* device, uint64_t offset)
     {
-        DeviceMemoryPtr ptr = nullptr;
-        VulkanResult    result;
-        result = vmaMapMemory(device->m_deviceAllocator, allocation, &ptr);
-        TL_ASSERT(result)
-        return ptr;
+        TL_ASSERT(mappedPtr, "Buffer was not created with BufferUsage::HostMapped");
+        return (uint8_t*)mappedPtr + offset;
     }
 
-    void IBuffer::Unmap(IDevice* device)
+    void IBuffer::Unmap(IDevice* device, uint64_t offset, uint64_t sizeBytes)
     {
-        vmaUnmapMemory(device->m_deviceAllocator, allocation);
+        // Memory stays mapped, only make host writes visible on non coherent heaps.
+        vmaFlushAllocation(device->m_deviceAllocator, allocation, offset, sizeBytes);
     }
 
     ////////////////////////////////////////////////////////////////////////
     // IImage
     ////////////////////////////////////////////////////////////////////////
 
-    ResultCode IImage::Init(IDevice* device, const ImageCreateInfo& createInfo)
+    inline static VkImageCreateInfo GetImageCreateInfo(const ImageCreateInfo& createInfo)
     {
-        this->format = createInfo.format;
-
-        VulkanResult result;
-
-        VmaAllocationCreateInfo allocationInfo{
-            .flags          = 0,
-            .usage          = VMA_MEMORY_USAGE_GPU_ONLY,
-            .requiredFlags  = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            .preferredFlags = 0,
-            .memoryTypeBits = 0,
-            .pool           = VK_NULL_HANDLE,
-            .pUserData      = nullptr,
-            .priority       = 0.0f,
-        };
-        VkImageCreateInfo imageCI{
+        return {
             .sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
             .pNext                 = nullptr,
             .flags                 = 0,
@@ -1482,18 +2524,48 @@ namespace RHI::Vulkan
             .pQueueFamilyIndices   = nullptr,
             .initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED,
         };
-        result = vkCreateImage(device->m_device, &imageCI, nullptr, &handle); //, &allocation, nullptr);
-        TL_ASSERT(result, "vkCreateImage failed with error: {}", result.AsString());
+    }
+
+    ResultCode IImage::Init(IDevice* device, const ImageCreateInfo& createInfo, const MemoryPlacement* placement)
+    {
+        this->format = createInfo.format;
+
+        VulkanResult      result;
+        VkImageCreateInfo imageCI = GetImageCreateInfo(createInfo);
+
+        if (placement)
+        {
+            // The memory belongs to the placement's owner.
+            allocation = VK_NULL_HANDLE;
+            result     = vmaCreateAliasingImage2(device->m_deviceAllocator, placement->allocation, placement->offset, &imageCI, &handle);
+            TL_ASSERT(result, "vmaCreateAliasingImage2 failed with error: {}", result.AsString());
+        }
+        else
+        {
+            VmaAllocationCreateInfo allocationInfo{
+                .flags          = 0,
+                .usage          = VMA_MEMORY_USAGE_GPU_ONLY,
+                .requiredFlags  = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                .preferredFlags = 0,
+                .memoryTypeBits = 0,
+                .pool           = VK_NULL_HANDLE,
+                .pUserData      = nullptr,
+                .priority       = 0.0f,
+            };
+            result = vkCreateImage(device->m_device, &imageCI, nullptr, &handle); //, &allocation, nullptr);
+            TL_ASSERT(result, "vkCreateImage failed with error: {}", result.AsString());
 
-        result = vmaAllocateMemoryForImage(device->m_deviceAllocator, handle, &allocationInfo, &allocation, nullptr);
-        TL_ASSERT(result, "vmaAllocateMemoryForImage failed with error: {}", result.AsString());
+            result = vmaAllocateMemoryForImage(device->m_deviceAllocator, handle, &allocationInfo, &allocation, nullptr);
+            TL_ASSERT(result, "vmaAllocateMemoryForImage failed with error: {}", result.AsString());
 
-        vmaBindImageMemory(device->m_deviceAllocator, allocation, handle);
+            vmaBindImageMemory(device->m_deviceAllocator, allocation, handle);
+        }
 
         if (result == VK_SUCCESS && !getName().empty())
         {
             device->SetDebugName(handle, getName().c_str());
-            vmaSetAllocationName(device->m_deviceAllocator, allocation, getName().c_str());
+            if (allocation)
+                vmaSetAllocationName(device->m_deviceAllocator, allocation, getName().c_str());
         }
 
         auto                   formatInfo = GetFormatInfo(format);
@@ -1591,7 +2663,7 @@ namespace RHI::Vulkan
 
     void IImage::Shutdown(IDevice* device)
     {
-        auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+        auto frame = device->GetLastSubmitValues();
 
         if (handle)
             device->m_destroyQueue->Push(frame, handle);
@@ -1603,6 +2675,208 @@ namespace RHI::Vulkan
             device->m_destroyQueue->Push(frame, allocation);
     }
 
+    ////////////////////////////////////////////////////////////////////////
+    // ITransientHeap
+    ////////////////////////////////////////////////////////////////////////
+
+    ResultCode ITransientHeap::Init(IDevice* device, const TransientHeapCreateInfo& createInfo)
+    {
+        ZoneScoped;
+
+        struct Placement
+        {
+            VkDeviceSize size;
+            VkDeviceSize alignment;
+            uint32_t     firstUse;
+            uint32_t     lastUse;
+            VkDeviceSize offset;
+            bool         placed;
+        };
+
+        // Images and buffers may end up next to each other, keep them on separate granularity pages.
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device->m_physicalDevice, &properties);
+        VkDeviceSize granularity = properties.limits.bufferImageGranularity;
+
+        TL::Vector<Placement> placements;
+        uint32_t              memoryTypeBits = UINT32_MAX;
+        VkDeviceSize          heapAlignment  = 1;
+
+        auto addPlacement = [&](const VkMemoryRequirements& requirements, uint32_t firstUse, uint32_t lastUse)
+        {
+            TL_ASSERT(firstUse <= lastUse);
+            VkDeviceSize alignment = std::max(requirements.alignment, granularity);
+            placements.push_back({AlignUp(requirements.size, alignment), alignment, firstUse, lastUse, 0, false});
+            memoryTypeBits &= requirements.memoryTypeBits;
+            heapAlignment   = std::max(heapAlignment, alignment);
+        };
+
+        for (const auto& imageInfo : createInfo.images)
+        {
+            VkImageCreateInfo               imageCI = GetImageCreateInfo(imageInfo.createInfo);
+            VkDeviceImageMemoryRequirements requirementsInfo{
+                .sType       = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+                .pNext       = nullptr,
+                .pCreateInfo = &imageCI,
+                .planeAspect = {},
+            };
+            VkMemoryRequirements2 requirements{.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+            vkGetDeviceImageMemoryRequirements(device->m_device, &requirementsInfo, &requirements);
+            addPlacement(requirements.memoryRequirements, imageInfo.firstUse, imageInfo.lastUse);
+        }
+
+        for (const auto& bufferInfo : createInfo.buffers)
+        {
+            VkBufferCreateInfo               bufferCI = GetBufferCreateInfo(device, bufferInfo.createInfo);
+            VkDeviceBufferMemoryRequirements requirementsInfo{
+                .sType       = VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS,
+                .pNext       = nullptr,
+                .pCreateInfo = &bufferCI,
+            };
+            VkMemoryRequirements2 requirements{.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+            vkGetDeviceBufferMemoryRequirements(device->m_device, &requirementsInfo, &requirements);
+            addPlacement(requirements.memoryRequirements, bufferInfo.firstUse, bufferInfo.lastUse);
+        }
+
+        if (placements.empty())
+            return ResultCode::Success;
+
+        if (memoryTypeBits == 0)
+        {
+            TL::LogError("Transient heap {}: resources have no memory type in common", getName());
+            return ResultCode::ErrorInvalidArguments;
+        }
+
+        auto lifetimesOverlap = [](const Placement& a, const Placement& b)
+        {
+            return a.firstUse <= b.lastUse && b.firstUse <= a.lastUse;
+        };
+
+        // Greedy first fit, largest resources first: each resource takes the lowest offset not used by a placed
+        // resource whose lifetime overlaps its own.
+        TL::Vector<uint32_t> order(placements.size());
+        for (uint32_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return placements[a].size > placements[b].size; });
+
+        VkDeviceSize         heapSize = 0;
+        TL::Vector<uint32_t> conflicts;
+        for (uint32_t index : order)
+        {
+            Placement& placement = placements[index];
+
+            conflicts.clear();
+            for (uint32_t other = 0; other < placements.size(); ++other)
+            {
+                if (placements[other].placed && lifetimesOverlap(placement, placements[other]))
+                    conflicts.push_back(other);
+            }
+            std::sort(conflicts.begin(), conflicts.end(), [&](uint32_t a, uint32_t b) { return placements[a].offset < placements[b].offset; });
+
+            VkDeviceSize offset = 0;
+            for (uint32_t other : conflicts)
+            {
+                const Placement& conflict = placements[other];
+                if (offset + placement.size <= conflict.offset)
+                    break;
+                offset = std::max(offset, AlignUp(conflict.offset + conflict.size, placement.alignment));
+            }
+
+            placement.offset = offset;
+            placement.placed = true;
+            heapSize         = std::max(heapSize, offset + placement.size);
+            stats.naiveSize += placement.size;
+        }
+        stats.peakSize = heapSize;
+
+        // Resources sharing memory with a resource whose lifetime ended need an aliasing barrier on first use.
+        TL::Vector<bool> aliased(placements.size(), false);
+        for (uint32_t a = 0; a < placements.size(); ++a)
+        {
+            for (uint32_t b = a + 1; b < placements.size(); ++b)
+            {
+                const Placement& pa = placements[a];
+                const Placement& pb = placements[b];
+                if (pa.offset >= pb.offset + pb.size || pb.offset >= pa.offset + pa.size)
+                    continue;
+
+                TL_ASSERT(!lifetimesOverlap(pa, pb));
+                aliased[a] = aliased[b] = true;
+                aliasingUsePoints.push_back(std::max(pa.firstUse, pb.firstUse));
+            }
+        }
+        // The heap is reused by the next execution, whose first passes take over memory the last occupants wrote.
+        if (!aliasingUsePoints.empty())
+            aliasingUsePoints.push_back(0);
+        std::sort(aliasingUsePoints.begin(), aliasingUsePoints.end());
+        aliasingUsePoints.erase(std::unique(aliasingUsePoints.begin(), aliasingUsePoints.end()), aliasingUsePoints.end());
+        stats.aliasedCount = (uint32_t)std::count(aliased.begin(), aliased.end(), true);
+
+        VkMemoryRequirements heapRequirements{
+            .size           = heapSize,
+            .alignment      = heapAlignment,
+            .memoryTypeBits = memoryTypeBits,
+        };
+        VmaAllocationCreateInfo allocationCI{
+            .flags          = 0,
+            .usage          = VMA_MEMORY_USAGE_GPU_ONLY,
+            .requiredFlags  = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .preferredFlags = 0,
+            .memoryTypeBits = 0,
+            .pool           = VK_NULL_HANDLE,
+            .pUserData      = nullptr,
+            .priority       = 0.0f,
+        };
+        VulkanResult result = vmaAllocateMemory(device->m_deviceAllocator, &heapRequirements, &allocationCI, &allocation, nullptr);
+        if (!result.IsSuccess())
+            return result;
+
+        if (!getName().empty())
+            vmaSetAllocationName(device->m_deviceAllocator, allocation, getName().c_str());
+
+        uint32_t placementIndex = 0;
+        for (const auto& imageInfo : createInfo.images)
+        {
+            MemoryPlacement memoryPlacement{allocation, placements[placementIndex++].offset};
+            auto            image = TL::construct<IImage>(imageInfo.createInfo.name ? TL::StringView(imageInfo.createInfo.name) : TL::StringView{});
+            if (auto imageResult = image->Init(device, imageInfo.createInfo, &memoryPlacement); IsError(imageResult))
+                return imageResult;
+            images.push_back(image);
+        }
+
+        for (const auto& bufferInfo : createInfo.buffers)
+        {
+            MemoryPlacement memoryPlacement{allocation, placements[placementIndex++].offset};
+            auto            buffer = TL::construct<IBuffer>(bufferInfo.createInfo.name ? TL::StringView(bufferInfo.createInfo.name) : TL::StringView{});
+            if (auto bufferResult = buffer->Init(device, bufferInfo.createInfo, &memoryPlacement); IsError(bufferResult))
+                return bufferResult;
+            buffers.push_back(buffer);
+        }
+
+        TL::LogInfo("Transient heap {}: {} bytes instead of {} ({} aliased resources)", getName(), stats.peakSize, stats.naiveSize, stats.aliasedCount);
+        return ResultCode::Success;
+    }
+
+    void ITransientHeap::Shutdown(IDevice* device)
+    {
+        for (auto image : images)
+        {
+            image->Shutdown(device);
+            TL::destruct(image);
+        }
+        for (auto buffer : buffers)
+        {
+            buffer->Shutdown(device);
+            TL::destruct(buffer);
+        }
+        images.clear();
+        buffers.clear();
+
+        auto frame = device->GetLastSubmitValues();
+        if (allocation)
+            device->m_destroyQueue->Push(frame, allocation);
+    }
+
     ////////////////////////////////////////////////////////////////////////
     // IAccelerationStructure
     ////////////////////////////////////////////////////////////////////////
@@ -1743,7 +3017,7 @@ namespace RHI::Vulkan
 
     void IAccelerationStructure::Shutdown(IDevice* device)
     {
-        auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+        auto frame = device->GetLastSubmitValues();
         if (handle) device->m_destroyQueue->Push(frame, handle);
         if (buffer) device->m_destroyQueue->Push(frame, buffer);
         if (allocation) device->m_destroyQueue->Push(frame, allocation);
@@ -1800,7 +3074,7 @@ namespace RHI::Vulkan
 
     void ISampler::Shutdown(IDevice* device)
     {
-        auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+        auto frame = device->GetLastSubmitValues();
         device->m_destroyQueue->Push(frame, handle);
     }
 
@@ -1840,7 +3114,7 @@ namespace RHI::Vulkan
 
     void ISwapchain::Shutdown(IDevice* device)
     {
-        auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+        auto frame = device->GetLastSubmitValues();
 
         for (uint32_t i = 0; i < MaxImageCount; ++i)
         {
@@ -2069,7 +3343,7 @@ namespace RHI::Vulkan
 
         // Destroy old image views and old swapchain if present
         {
-            auto frame = ((IQueue*)device->GetQueue(QueueType::Graphics))->m_lastSubmitValue.load();
+            auto frame = device->GetLastSubmitValues();
             for (uint32_t i = 0; i < MaxImageCount; i++)
             {
                 if (m_imageViews[i] != VK_NULL_HANDLE)
@@ -2180,7 +3454,11 @@ namespace RHI::Vulkan
 
     VkResult ISwapchain::Present(IDevice* device, TL::Span<Fence* const> fences)
     {
-        TL::Vector<VkSemaphore> waitSemaphores{device->m_arena};
+        IQueue*         graphicsQueue = (IQueue*)device->GetQueue(QueueType::Graphics);
+        std::lock_guard lock(*graphicsQueue->m_mutex);
+        graphicsQueue->m_arena.reset();
+
+        TL::Vector<VkSemaphore> waitSemaphores{graphicsQueue->m_arena};
         for (auto& _fence : fences)
         {
             auto fence = (IFence*)_fence;
@@ -2190,7 +3468,6 @@ namespace RHI::Vulkan
 
         VkResult presentResult;
 
-        IQueue*          graphicsQueue = (IQueue*)device->GetQueue(QueueType::Graphics);
         VkPresentInfoKHR presentInfo{
             .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
             .pNext              = nullptr,
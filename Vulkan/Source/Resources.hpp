@@ -12,6 +12,8 @@
 #include <TL/Stacktrace.hpp>
 #include <TL/Utils.hpp>
 
+#include <mutex>
+
 #include <vk_mem_alloc.h>
 
 namespace RHI::Vulkan
@@ -43,6 +45,13 @@ namespace RHI::Vulkan
     VkImageAspectFlags      ConvertImageAspect(TL::Flags<ImageAspect> imageAspect, Format format);
     VkImageSubresourceRange ConvertSubresourceRange(const ImageSubresourceRange& subresource, Format format);
 
+    // Unique for the process lifetime, lets caches key resources without relying on addresses that may be reused.
+    inline uint64_t NextResourceId()
+    {
+        static std::atomic_uint64_t s_nextId = 1;
+        return s_nextId.fetch_add(1, std::memory_order_relaxed);
+    }
+
     class DescriptorSetWriter
     {
     public:
@@ -78,13 +87,61 @@ namespace RHI::Vulkan
         void     Shutdown();
 
         ResultCode InitBindGroup(IBindGroup* bindGroup, IBindGroupLayout* bindGroupLayout, uint32_t bindlessResourcesCount);
+        // Releases the group's descriptors through the delete queue once the GPU is done with them.
         void       ShutdownBindGroup(IBindGroup* bindGroup);
+        // Writes descriptors straight into the descriptor buffer, replaces vkUpdateDescriptorSets on that path.
+        void       WriteBindGroup(IBindGroup* bindGroup, const BindGroupUpdateInfo& updateInfo);
+
+        // Sub-allocations of the descriptor buffer, offset is relative to m_descriptorBufferAddress.
+        ResultCode AllocateDescriptorRange(VkDeviceSize size, VmaVirtualAllocation& allocation, VkDeviceSize& offset);
+        void       FreeDescriptorRange(VmaVirtualAllocation allocation);
 
         void Reset();
 
     public:
         IDevice*         m_device;
-        VkDescriptorPool m_descriptorPool;
+        VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+        // Used instead of the pool when DeviceFeatures::hasDescriptorBuffer is set,
+        // bind groups are sub-allocations of one persistently mapped buffer.
+        VkBuffer         m_descriptorBuffer           = VK_NULL_HANDLE;
+        VmaAllocation    m_descriptorBufferAllocation = VK_NULL_HANDLE;
+        VkDeviceAddress  m_descriptorBufferAddress    = 0;
+        uint8_t*         m_descriptorBufferPtr        = nullptr;
+        VmaVirtualBlock  m_descriptorBufferBlock      = VK_NULL_HANDLE;
+        std::mutex       m_descriptorBufferMutex;
+    };
+
+    // Linear allocator for bind groups that only live for one frame. Nothing is freed individually, Reset releases
+    // every group at once after the GPU retired the owning frame. Backed by descriptor pools without the free bit,
+    // or by chunks of the descriptor buffer, more of either are chained when the current one runs out.
+    class TransientBindGroupAllocator
+    {
+    public:
+        void        Init(IDevice* device);
+        void        Shutdown();
+
+        IBindGroup* Allocate(const BindGroupCreateInfo& createInfo);
+        void        Reset();
+
+    private:
+        struct DescriptorChunk
+        {
+            VmaVirtualAllocation allocation;
+            VkDeviceSize         offset;
+            VkDeviceSize         size;
+        };
+
+        ResultCode AllocateDescriptorSet(IBindGroup* bindGroup, uint32_t bindlessResourcesCount);
+        ResultCode AllocateDescriptorRange(IBindGroup* bindGroup, uint32_t bindlessResourcesCount);
+
+        IDevice*                     m_device = nullptr;
+        std::mutex                   m_mutex;
+        TL::Vector<IBindGroup*>      m_bindGroups;
+        TL::Vector<VkDescriptorPool> m_descriptorPools;
+        uint32_t                     m_descriptorPoolIndex = 0;
+        TL::Vector<DescriptorChunk>  m_descriptorChunks;
+        uint32_t                     m_descriptorChunkIndex = 0;
+        VkDeviceSize                 m_descriptorChunkUsed  = 0;
     };
 
     struct IFence : Fence
@@ -109,13 +166,26 @@ namespace RHI::Vulkan
         {
         }
 
-        VkDescriptorSetLayout      handle = VK_NULL_HANDLE;
+        VkDescriptorSetLayout      handle   = VK_NULL_HANDLE;
+        uint64_t                   uniqueId = NextResourceId();
         // TODO: Figure out why TL::Vector causes leaks here
         std::vector<ShaderBinding> shaderBindings;
         bool                       hasBindless = false;
-
-        ResultCode Init(IDevice* device, const BindGroupLayoutCreateInfo& createInfo);
+        // Descriptor buffer path, size of a group and the offset of each binding within it.
+        VkDeviceSize               descriptorSize = 0;
+        std::vector<VkDeviceSize>  bindingOffsets;
+        // Descriptor set path without bindless bindings, updates write a packed copy of the whole set through it.
+        VkDescriptorUpdateTemplate updateTemplate          = VK_NULL_HANDLE;
+        uint32_t                   templateDataSize        = 0;
+        uint32_t                   templateDescriptorCount = 0;
+        // Byte offset and first descriptor index of each binding within the packed data.
+        std::vector<uint32_t>      templateOffsets;
+        std::vector<uint32_t>      templateFirstDescriptor;
+
+        // partiallyBound leaves every binding partially bound and updatable after bind, as the bindless heap needs.
+        ResultCode Init(IDevice* device, const BindGroupLayoutCreateInfo& createInfo, bool partiallyBound = false);
         void       Shutdown(IDevice* device);
+        ResultCode InitUpdateTemplate(IDevice* device);
 
         ShaderBinding GetBinding(uint32_t binding) const { return shaderBindings[binding]; }
     };
@@ -127,13 +197,27 @@ namespace RHI::Vulkan
         {
         }
 
-        VkDescriptorSet   descriptorSet;
-        IBindGroupLayout* bindGroupLayout;
+        VkDescriptorSet      descriptorSet;
+        IBindGroupLayout*    bindGroupLayout;
+        // Descriptor buffer path, the group's range of the buffer.
+        VmaVirtualAllocation descriptorAllocation = VK_NULL_HANDLE;
+        VkDeviceSize         descriptorOffset     = 0;
+        // Owned by a frame's TransientBindGroupAllocator, never destroyed on its own.
+        bool                 transient            = false;
+        // Shared through the device's BindGroupCache, key of the group's contents.
+        bool                 cached               = false;
+        uint64_t             cacheKey             = 0;
+        // Scratch for updates in the layout's update template format. The template rewrites every descriptor, so it
+        // is only used by updates that write all of them, descriptors of earlier updates may be stale by now.
+        std::vector<uint8_t> templateData;
+        std::vector<bool>    templateWritten;
 
         ResultCode Init(IDevice* device, const BindGroupCreateInfo& createInfo);
         void       Shutdown(IDevice* device);
 
         void Update(IDevice* device, const BindGroupUpdateInfo& updateInfo);
+        // Returns true when the update wrote every descriptor of the template.
+        bool PackTemplateData(const BindGroupUpdateInfo& updateInfo);
     };
 
     struct IShaderModule : ShaderModule
@@ -143,7 +227,13 @@ namespace RHI::Vulkan
         {
         }
 
-        VkShaderModule m_shaderModule;
+        VkShaderModule              m_shaderModule;
+        // Kept when shader objects are supported, vkCreateShadersEXT takes SPIR-V rather than a module.
+        TL::Vector<uint32_t>        m_code;
+        // Key in the device's shader module cache, also identifies the module across runs in the pipeline manifest.
+        uint64_t                    m_contentHash = 0;
+        // Set when hasShaderModuleIdentifier, lets pipelines be found in the pipeline cache without passing the SPIR-V.
+        VkShaderModuleIdentifierEXT m_identifier  = {.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_IDENTIFIER_EXT};
 
         ResultCode Init(IDevice* device, const ShaderModuleCreateInfo& createInfo);
         void       Shutdown(IDevice* device);
@@ -156,14 +246,39 @@ namespace RHI::Vulkan
         {
         }
 
-        VkPipelineLayout   handle;
-        IBindGroupLayout*  bindGroupLayouts[4];
-        VkShaderStageFlags pushConstantStages = 0;
+        VkPipelineLayout                  handle;
+        IBindGroupLayout*                 bindGroupLayouts[4];
+        VkShaderStageFlags                pushConstantStages = 0;
+        // Shader objects are created against the layout's description rather than its handle.
+        TL::Vector<VkDescriptorSetLayout> setLayouts;
+        TL::Vector<VkPushConstantRange>   pushConstantRanges;
+        // Identifies the layout across runs in the pipeline manifest.
+        uint64_t                          contentHash = 0;
+        uint64_t                          uniqueId    = NextResourceId();
+        // Group the bindless heap is bound to when the layout is, UINT32_MAX when the layout does not use it.
+        uint32_t                          bindlessGroup = UINT32_MAX;
 
         ResultCode Init(IDevice* device, const PipelineLayoutCreateInfo& createInfo);
         void       Shutdown(IDevice* device);
     };
 
+    // State of a pipeline created with dynamicState, applied by the command list when the pipeline is bound.
+    struct GraphicsPipelineDynamicState
+    {
+        static constexpr uint32_t MaxColorAttachments = 8;
+
+        bool                             enabled                           = false;
+        PipelineRasterizerStateCullMode  cullMode                          = PipelineRasterizerStateCullMode::BackFace;
+        PipelineRasterizerStateFrontFace frontFace                         = PipelineRasterizerStateFrontFace::CounterClockwise;
+        PipelineDepthStencilStateDesc    depthStencilState                 = {};
+        uint32_t                         colorAttachmentCount              = 0;
+        bool                             blendEnables[MaxColorAttachments] = {};
+
+        // Only the values belonging to parts are taken, a linked pipeline merges those of its libraries.
+        void Init(const GraphicsPipelineCreateInfo& createInfo, TL::Flags<GraphicsPipelineLibraryPart> parts);
+        void Merge(const GraphicsPipelineDynamicState& other, TL::Flags<GraphicsPipelineLibraryPart> parts);
+    };
+
     struct IGraphicsPipeline : GraphicsPipeline
     {
         IGraphicsPipeline(TL::StringView name = {})
@@ -171,11 +286,74 @@ namespace RHI::Vulkan
         {
         }
 
-        VkPipeline       handle;
-        IPipelineLayout* layout;
+        VkPipeline                   handle          = VK_NULL_HANDLE;
+        IPipelineLayout*             layout          = nullptr;
+        // Cleared while the pipeline is compiled asynchronously.
+        std::atomic_bool             ready           = true;
+        // Key of the pipeline in the device's PipelineStateCache.
+        uint64_t                     cacheKey        = 0;
+        // Link time optimized version of a linked pipeline, replaces handle once compiled in the background.
+        std::atomic<VkPipeline>      optimizedHandle = VK_NULL_HANDLE;
+        GraphicsPipelineDynamicState dynamicState;
 
         ResultCode Init(IDevice* device, const GraphicsPipelineCreateInfo& createInfo);
+        // Fast links the libraries, or links them with link time optimization into optimizedHandle.
+        ResultCode Link(IDevice* device, const GraphicsPipelineLinkInfo& linkInfo, bool optimize);
+        void       Shutdown(IDevice* device);
+
+        VkPipeline GetBindHandle() const
+        {
+            VkPipeline optimized = optimizedHandle.load(std::memory_order_acquire);
+            return optimized != VK_NULL_HANDLE ? optimized : handle;
+        }
+    };
+
+    struct IGraphicsPipelineLibrary : GraphicsPipelineLibrary
+    {
+        IGraphicsPipelineLibrary(TL::StringView name = {})
+            : GraphicsPipelineLibrary(name)
+        {
+        }
+
+        VkPipeline                             handle   = VK_NULL_HANDLE;
+        TL::Flags<GraphicsPipelineLibraryPart> parts    = GraphicsPipelineLibraryPart::None;
+        uint64_t                               uniqueId = NextResourceId();
+        GraphicsPipelineDynamicState           dynamicState;
+
+        ResultCode Init(IDevice* device, const GraphicsPipelineLibraryCreateInfo& createInfo);
+        void       Shutdown(IDevice* device);
+    };
+
+    struct IShaderObject : ShaderObject
+    {
+        IShaderObject(TL::StringView name = {})
+            : ShaderObject(name)
+        {
+        }
+
+        static constexpr uint32_t MaxStages = 4;
+
+        VkShaderEXT                                       shaders[MaxStages] = {};
+        VkShaderStageFlagBits                             stages[MaxStages]  = {};
+        uint32_t                                          stageCount         = 0;
+        IPipelineLayout*                                  layout             = nullptr;
+        // Graphics state recorded by BindShaders, shader objects have none baked in.
+        TL::Vector<VkVertexInputBindingDescription2EXT>   vertexBindings;
+        TL::Vector<VkVertexInputAttributeDescription2EXT> vertexAttributes;
+        TL::Vector<VkColorBlendEquationEXT>               blendEquations;
+        TL::Vector<VkColorComponentFlags>                 writeMasks;
+        GraphicsPipelineDynamicState                      dynamicState;
+        VkPrimitiveTopology                               topology           = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        VkPolygonMode                                     polygonMode        = VK_POLYGON_MODE_FILL;
+        float                                             lineWidth          = 1.0f;
+        VkSampleCountFlagBits                             sampleCount        = VK_SAMPLE_COUNT_1_BIT;
+        float                                             blendConstants[4]  = {};
+        VkStencilOpState                                  stencilState       = {};
+
+        ResultCode Init(IDevice* device, const ShaderObjectCreateInfo& createInfo);
         void       Shutdown(IDevice* device);
+
+        bool IsCompute() const { return stages[0] == VK_SHADER_STAGE_COMPUTE_BIT; }
     };
 
     struct IComputePipeline : ComputePipeline
@@ -185,8 +363,10 @@ namespace RHI::Vulkan
         {
         }
 
-        VkPipeline       handle;
-        IPipelineLayout* layout;
+        VkPipeline       handle   = VK_NULL_HANDLE;
+        IPipelineLayout* layout   = nullptr;
+        std::atomic_bool ready    = true;
+        uint64_t         cacheKey = 0;
 
         ResultCode Init(IDevice* device, const ComputePipelineCreateInfo& createInfo);
         void       Shutdown(IDevice* device);
@@ -199,8 +379,10 @@ namespace RHI::Vulkan
         {
         }
 
-        VkPipeline       handle;
-        IPipelineLayout* layout;
+        VkPipeline       handle   = VK_NULL_HANDLE;
+        IPipelineLayout* layout   = nullptr;
+        std::atomic_bool ready    = true;
+        uint64_t         cacheKey = 0;
 
         ResultCode Init(IDevice* device, const RayTracingPipelineCreateInfo& createInfo);
         void       Shutdown(IDevice* device);
@@ -221,6 +403,13 @@ namespace RHI::Vulkan
         void       Shutdown(IDevice* device);
     };
 
+    // Range of an allocation owned by someone else, used to alias resources into a shared heap.
+    struct MemoryPlacement
+    {
+        VmaAllocation allocation;
+        VkDeviceSize  offset;
+    };
+
     struct IBuffer : Buffer
     {
         IBuffer(TL::StringView name = {})
@@ -231,12 +420,16 @@ namespace RHI::Vulkan
         VkBuffer        handle;
         VmaAllocation   allocation;
         VkDeviceAddress address;
+        VkDeviceSize    size;
+        uint64_t        uniqueId = NextResourceId();
+        // Persistent mapping of HostMapped buffers, null otherwise.
+        void*           mappedPtr = nullptr;
 
-        ResultCode Init(IDevice* device, const BufferCreateInfo& createInfo);
+        ResultCode Init(IDevice* device, const BufferCreateInfo& createInfo, const MemoryPlacement* placement = nullptr);
         void       Shutdown(IDevice* device);
 
-        DeviceMemoryPtr Map(IDevice* device);
-        void            Unmap(IDevice* device);
+        DeviceMemoryPtr Map(IDevice* device, uint64_t offset = 0);
+        void            Unmap(IDevice* device, uint64_t offset = 0, uint64_t sizeBytes = VK_WHOLE_SIZE);
     };
 
     struct IImage : Image
@@ -249,18 +442,37 @@ namespace RHI::Vulkan
         VkImage       handle;
         VkImageView   viewHandle;
         VmaAllocation allocation;
+        uint64_t      uniqueId = NextResourceId();
 
         // TODO: the following should be removed
         ImageSize3D           size;
         Format                format;
         ImageSubresourceRange subresources;
 
-        ResultCode Init(IDevice* device, const ImageCreateInfo& createInfo);
+        ResultCode Init(IDevice* device, const ImageCreateInfo& createInfo, const MemoryPlacement* placement = nullptr);
         ResultCode Init(IDevice* device, const ImageViewCreateInfo& createInfo);
         ResultCode Init(IDevice* device, VkImage image, const VkSwapchainCreateInfoKHR& swapchainCreateInfo);
         void       Shutdown(IDevice* device);
     };
 
+    struct ITransientHeap : TransientHeap
+    {
+        ITransientHeap(TL::StringView name = {})
+            : TransientHeap(name)
+        {
+        }
+
+        VmaAllocation        allocation = VK_NULL_HANDLE;
+        TL::Vector<IImage*>  images;
+        TL::Vector<IBuffer*> buffers;
+        // Sorted use points where a resource starts reusing memory of a resource whose lifetime ended.
+        TL::Vector<uint32_t> aliasingUsePoints;
+        TransientHeapStats   stats;
+
+        ResultCode Init(IDevice* device, const TransientHeapCreateInfo& createInfo);
+        void       Shutdown(IDevice* device);
+    };
+
     struct ISampler : Sampler
     {
         ISampler(TL::StringView name = {})
@@ -269,6 +481,7 @@ namespace RHI::Vulkan
         }
 
         VkSampler handle;
+        uint64_t  uniqueId = NextResourceId();
 
         ResultCode Init(IDevice* device, const SamplerCreateInfo& createInfo);
         void       Shutdown(IDevice* device);
@@ -281,7 +494,8 @@ namespace RHI::Vulkan
         {
         }
 
-        VkAccelerationStructureKHR handle = VK_NULL_HANDLE;
+        VkAccelerationStructureKHR handle   = VK_NULL_HANDLE;
+        uint64_t                   uniqueId = NextResourceId();
 
         VkDeviceAddress address = 0;
 
@@ -0,0 +1,380 @@
+#include "Upload.hpp"
+#include "Common.hpp"
+#include "Device.hpp"
+#include "Resources.hpp"
+
+#include <TL/Log.hpp>
+
+#include <cstring>
+
+#include <tracy/Tracy.hpp>
+
+namespace RHI::Vulkan
+{
+    // vkCmdCopyBufferToImage requires the buffer offset to be a multiple of the texel block size.
+    constexpr size_t BufferCopyAlignment = 4;
+    constexpr size_t ImageCopyAlignment  = 16;
+
+    ////////////////////////////////////////////////////////////////////////
+    // StagingRing
+    ////////////////////////////////////////////////////////////////////////
+
+    ResultCode StagingRing::Init(IDevice* device, const char* name, size_t capacity, TL::Flags<BufferUsage> usageFlags)
+    {
+        BufferCreateInfo bufferCI{
+            .name       = name,
+            .usageFlags = usageFlags | BufferUsage::HostMapped,
+            .byteSize   = capacity,
+        };
+        m_buffer = (IBuffer*)device->CreateBuffer(bufferCI);
+        if (m_buffer == nullptr)
+            return ResultCode::ErrorOutOfMemory;
+
+        m_mappedPtr = (uint8_t*)m_buffer->Map(device);
+        m_capacity  = capacity;
+        return ResultCode::Success;
+    }
+
+    void StagingRing::Shutdown(IDevice* device)
+    {
+        if (m_buffer == nullptr)
+            return;
+
+        device->DestroyBuffer(m_buffer);
+        m_buffer    = nullptr;
+        m_mappedPtr = nullptr;
+        m_retiredRegions.clear();
+    }
+
+    bool StagingRing::Allocate(size_t size, size_t alignment, Allocation& allocation)
+    {
+        // Wrap around, the tail of the buffer is wasted until this region is reclaimed.
+        bool   wrap     = AlignUp(m_head, alignment) + size > m_capacity;
+        size_t offset   = wrap ? 0 : AlignUp(m_head, alignment);
+        size_t consumed = (wrap ? m_capacity - m_head : offset - m_head) + size;
+        if (m_usedSize + consumed > m_capacity)
+            return false;
+
+        m_head         = offset + size;
+        m_usedSize    += consumed;
+        m_pendingSize += consumed;
+
+        allocation.buffer = m_buffer;
+        allocation.offset = offset;
+        allocation.ptr    = m_mappedPtr + offset;
+        return true;
+    }
+
+    void StagingRing::Retire(uint64_t timelineValue)
+    {
+        if (m_pendingSize == 0)
+            return;
+
+        m_retiredRegions.push_back({timelineValue, m_pendingSize});
+        m_pendingSize = 0;
+    }
+
+    void StagingRing::Reclaim(uint64_t completedValue)
+    {
+        size_t count = 0;
+        for (; count < m_retiredRegions.size() && m_retiredRegions[count].timelineValue <= completedValue; ++count)
+            m_usedSize -= m_retiredRegions[count].size;
+        m_retiredRegions.erase(m_retiredRegions.begin(), m_retiredRegions.begin() + count);
+
+        // Start over from the beginning once idle to avoid needless wrapping.
+        if (m_usedSize == 0)
+            m_head = 0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // UploadEngine
+    ////////////////////////////////////////////////////////////////////////
+
+    ResultCode UploadEngine::Init(IDevice* device)
+    {
+        m_device = device;
+
+        m_fence = (IFence*)device->CreateFence({.name = "UploadEngine - timeline", .initialValue = 0});
+        if (m_fence == nullptr)
+            return ResultCode::ErrorUnknown;
+
+        if (auto result = m_stagingRing.Init(device, "UploadEngine - staging ring", StagingRingSize, BufferUsage::CopySrc); IsError(result))
+            return result;
+
+        for (uint32_t i = 0; i < BatchCount; ++i)
+        {
+            auto transferName         = TL::fmt("UploadEngine[{}] - Transfer", i);
+            auto graphicsName         = TL::fmt("UploadEngine[{}] - Graphics", i);
+            m_batches[i].transferPool = (ICommandPool*)device->CreateCommandPool({.name = transferName.c_str(), .queue = QueueType::Transfer});
+            m_batches[i].graphicsPool = (ICommandPool*)device->CreateCommandPool({.name = graphicsName.c_str(), .queue = QueueType::Graphics});
+        }
+        return ResultCode::Success;
+    }
+
+    void UploadEngine::Shutdown(IDevice* device)
+    {
+        for (auto& batch : m_batches)
+        {
+            for (auto buffer : batch.dedicatedBuffers)
+                device->DestroyBuffer(buffer);
+            batch.dedicatedBuffers.clear();
+
+            if (batch.transferPool)
+                device->DestroyCommandPool(batch.transferPool);
+            if (batch.graphicsPool)
+                device->DestroyCommandPool(batch.graphicsPool);
+            batch = {};
+        }
+
+        m_stagingRing.Shutdown(device);
+
+        if (m_fence)
+            device->DestroyFence(m_fence);
+        m_fence = nullptr;
+    }
+
+    uint64_t UploadEngine::UploadBuffer(const BufferUploadInfo& uploadInfo)
+    {
+        ZoneScoped;
+
+        TL_ASSERT(uploadInfo.buffer && uploadInfo.data);
+
+        std::lock_guard lock(m_mutex);
+
+        auto   buffer     = (IBuffer*)uploadInfo.buffer;
+        Batch& batch      = OpenBatch();
+        auto   allocation = AllocateStaging(batch, uploadInfo.size, BufferCopyAlignment);
+
+        memcpy(allocation.ptr, uploadInfo.data, uploadInfo.size);
+        vmaFlushAllocation(m_device->m_deviceAllocator, allocation.buffer->allocation, allocation.offset, uploadInfo.size);
+
+        batch.transferList->CopyBuffer(allocation.buffer, allocation.offset, buffer, uploadInfo.offset, uploadInfo.size);
+
+        BufferBarrierInfo releaseBarrier{
+            .buffer    = buffer,
+            .srcState  = {.usage = BufferUsage::CopyDst, .stage = PipelineStage::Transfer, .access = Access::Write},
+            .dstState  = {.usage = BufferUsage::None, .stage = PipelineStage::AllCommands, .access = Access::Read},
+            .subregion = {.offset = uploadInfo.offset, .size = uploadInfo.size},
+            .srcQueue  = QueueType::Transfer,
+            .dstQueue  = QueueType::Graphics,
+        };
+        batch.transferList->AddPipelineBarrier({}, {}, {&releaseBarrier, 1});
+
+        auto& queues = m_device->m_queue;
+        if (queues[(uint32_t)QueueType::Transfer].m_familyIndex != queues[(uint32_t)QueueType::Graphics].m_familyIndex)
+            batch.bufferAcquires.push_back(releaseBarrier);
+
+        if (uploadInfo.callback)
+            batch.callbacks.push_back({uploadInfo.callback, uploadInfo.userData});
+
+        return batch.timelineValue;
+    }
+
+    uint64_t UploadEngine::UploadImage(const ImageUploadInfo& uploadInfo)
+    {
+        ZoneScoped;
+
+        TL_ASSERT(uploadInfo.image && uploadInfo.data);
+
+        std::lock_guard lock(m_mutex);
+
+        auto   image      = (IImage*)uploadInfo.image;
+        Batch& batch      = OpenBatch();
+        auto   allocation = AllocateStaging(batch, uploadInfo.size, ImageCopyAlignment);
+
+        memcpy(allocation.ptr, uploadInfo.data, uploadInfo.size);
+        vmaFlushAllocation(m_device->m_deviceAllocator, allocation.buffer->allocation, allocation.offset, uploadInfo.size);
+
+        ImageSubresourceRange subresource{
+            .imageAspects  = uploadInfo.aspect,
+            .mipBase       = (uint8_t)uploadInfo.mipLevel,
+            .mipLevelCount = 1,
+            .arrayBase     = (uint8_t)uploadInfo.arrayLayer,
+            .arrayCount    = 1,
+        };
+
+        // Previous content is discarded, the whole mip level is overwritten.
+        ImageBarrierInfo copyBarrier{
+            .image       = image,
+            .srcState    = {.usage = ImageUsage::None, .stage = PipelineStage::None, .access = Access::None},
+            .dstState    = {.usage = ImageUsage::CopyDst, .stage = PipelineStage::Transfer, .access = Access::Write},
+            .subresource = subresource,
+        };
+        batch.transferList->AddPipelineBarrier({}, {&copyBarrier, 1}, {});
+
+        ImageCopyInfo copyInfo{
+            .image      = image,
+            .mipLevel   = uploadInfo.mipLevel,
+            .arrayLayer = uploadInfo.arrayLayer,
+            .offset     = {},
+            .aspect     = uploadInfo.aspect,
+        };
+        batch.transferList->CopyBufferToImage(allocation.buffer, copyInfo, {.offset = allocation.offset, .bytesPerRow = 0, .rowsPerImage = 0});
+
+        ImageBarrierInfo releaseBarrier{
+            .image       = image,
+            .srcState    = {.usage = ImageUsage::CopyDst, .stage = PipelineStage::Transfer, .access = Access::Write},
+            .dstState    = {.usage = ImageUsage::ShaderResource, .stage = PipelineStage::AllCommands, .access = Access::Read},
+            .subresource = subresource,
+            .srcQueue    = QueueType::Transfer,
+            .dstQueue    = QueueType::Graphics,
+        };
+        batch.transferList->AddPipelineBarrier({}, {&releaseBarrier, 1}, {});
+
+        auto& queues = m_device->m_queue;
+        if (queues[(uint32_t)QueueType::Transfer].m_familyIndex != queues[(uint32_t)QueueType::Graphics].m_familyIndex)
+            batch.imageAcquires.push_back(releaseBarrier);
+
+        if (uploadInfo.callback)
+            batch.callbacks.push_back({uploadInfo.callback, uploadInfo.userData});
+
+        return batch.timelineValue;
+    }
+
+    uint64_t UploadEngine::Flush()
+    {
+        std::lock_guard lock(m_mutex);
+        return FlushLocked();
+    }
+
+    void UploadEngine::Poll()
+    {
+        ZoneScoped;
+
+        TL::Vector<PendingCallback> callbacks;
+        {
+            std::lock_guard lock(m_mutex);
+            ReclaimLocked();
+            std::swap(callbacks, m_readyCallbacks);
+        }
+
+        // Invoked without the lock held so callbacks may issue new uploads.
+        for (auto [callback, userData] : callbacks)
+            callback(userData);
+    }
+
+    UploadEngine::Batch& UploadEngine::OpenBatch()
+    {
+        Batch& batch = m_batches[m_batchIndex];
+        if (m_batchOpen)
+            return batch;
+
+        // Both halves of the batch previously recorded from this slot must have retired before resetting its pools.
+        if (batch.timelineValue != 0)
+        {
+            m_fence->waitValue(m_device, batch.timelineValue);
+
+            IQueue& graphicsQueue = m_device->m_queue[(uint32_t)QueueType::Graphics];
+            if (graphicsQueue.GetCompletedValue() < batch.graphicsTimelineValue)
+                graphicsQueue.WaitFence(&graphicsQueue.m_timeline, batch.graphicsTimelineValue);
+
+            ReclaimLocked();
+        }
+
+        batch.transferPool->Reset();
+        batch.graphicsPool->Reset();
+        batch.imageAcquires.clear();
+        batch.bufferAcquires.clear();
+
+        batch.timelineValue = ++m_lastBatchValue;
+        batch.transferList  = (ICommandList*)batch.transferPool->Allocate();
+        batch.transferList->Begin();
+
+        m_batchOpen = true;
+        return batch;
+    }
+
+    StagingRing::Allocation UploadEngine::AllocateStaging(Batch& batch, size_t size, size_t alignment)
+    {
+        StagingRing::Allocation allocation;
+
+        // Uploads may come from any thread, so a full ring never submits. It waits for regions that were already
+        // submitted to retire, and only falls back to a dedicated buffer when the open batch holds the whole ring.
+        bool fits = size <= m_stagingRing.GetCapacity();
+        while (fits && !m_stagingRing.Allocate(size, alignment, allocation))
+        {
+            if (!m_stagingRing.HasRetiredRegions())
+            {
+                fits = false;
+                break;
+            }
+            m_fence->waitValue(m_device, m_stagingRing.GetOldestRetiredValue());
+            ReclaimLocked();
+        }
+        if (fits)
+            return allocation;
+
+        BufferCreateInfo bufferCI{
+            .name       = "UploadEngine - dedicated staging",
+            .usageFlags = BufferUsage::HostMapped | BufferUsage::CopySrc,
+            .byteSize   = size,
+        };
+        allocation.buffer = (IBuffer*)m_device->CreateBuffer(bufferCI);
+        allocation.offset = 0;
+        allocation.ptr    = allocation.buffer->Map(m_device);
+        batch.dedicatedBuffers.push_back(allocation.buffer);
+        return allocation;
+    }
+
+    uint64_t UploadEngine::FlushLocked()
+    {
+        ZoneScoped;
+
+        if (!m_batchOpen)
+            return m_lastBatchValue;
+
+        Batch&  batch         = m_batches[m_batchIndex];
+        IQueue& transferQueue = m_device->m_queue[(uint32_t)QueueType::Transfer];
+        IQueue& graphicsQueue = m_device->m_queue[(uint32_t)QueueType::Graphics];
+
+        batch.transferList->End();
+
+        CommandList*    transferList = batch.transferList;
+        FenceSubmitInfo uploadSignal{.fence = m_fence, .value = batch.timelineValue, .stage = PipelineStage::AllCommands};
+        transferQueue.Submit({.commandLists = {&transferList, 1}, .signalFences = {&uploadSignal, 1}});
+
+        // The acquire half of the ownership transfers, followed by a global barrier so every later graphics
+        // submission observes the uploaded data.
+        auto acquireList = (ICommandList*)batch.graphicsPool->Allocate();
+        acquireList->Begin();
+        if (!batch.imageAcquires.empty() || !batch.bufferAcquires.empty())
+            acquireList->AddPipelineBarrier({}, batch.imageAcquires, batch.bufferAcquires);
+        BarrierInfo memoryBarrier{
+            .srcState = {.stage = PipelineStage::AllCommands, .access = Access::Write},
+            .dstState = {.stage = PipelineStage::AllCommands, .access = Access::Read | Access::Write},
+        };
+        acquireList->AddPipelineBarrier({&memoryBarrier, 1}, {}, {});
+        acquireList->End();
+
+        CommandList*    graphicsList = acquireList;
+        FenceSubmitInfo uploadWait{.fence = m_fence, .value = batch.timelineValue, .stage = PipelineStage::AllCommands};
+        batch.graphicsTimelineValue = graphicsQueue.Submit({.waitFences = {&uploadWait, 1}, .commandLists = {&graphicsList, 1}});
+
+        m_stagingRing.Retire(batch.timelineValue);
+
+        // Released through the delete queue, keyed on the graphics timeline which already waits on this batch.
+        for (auto buffer : batch.dedicatedBuffers)
+            m_device->DestroyBuffer(buffer);
+        batch.dedicatedBuffers.clear();
+
+        m_batchIndex = (m_batchIndex + 1) % BatchCount;
+        m_batchOpen  = false;
+        return batch.timelineValue;
+    }
+
+    void UploadEngine::ReclaimLocked()
+    {
+        uint64_t completedValue = m_device->GetFenceValue(m_fence);
+        m_stagingRing.Reclaim(completedValue);
+
+        for (auto& batch : m_batches)
+        {
+            if (batch.timelineValue == 0 || batch.timelineValue > completedValue)
+                continue;
+
+            for (auto& pendingCallback : batch.callbacks)
+                m_readyCallbacks.push_back(pendingCallback);
+            batch.callbacks.clear();
+        }
+    }
+} // namespace RHI::Vulkan
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <RHI/RHI.h>
+
+#include <TL/Containers/Vector.hpp>
+
+#include <mutex>
+
+namespace RHI::Vulkan
+{
+    class IDevice;
+    class ICommandPool;
+    class ICommandList;
+    struct IBuffer;
+    struct IFence;
+
+    // Persistently mapped host visible buffer, sub-allocated as a ring. Regions are handed back once the timeline
+    // value they were retired with has been reached.
+    class StagingRing
+    {
+    public:
+        struct Allocation
+        {
+            IBuffer* buffer = nullptr;
+            size_t   offset = 0;
+            void*    ptr    = nullptr;
+        };
+
+        ResultCode Init(IDevice* device, const char* name, size_t capacity, TL::Flags<BufferUsage> usageFlags);
+        void       Shutdown(IDevice* device);
+
+        // Returns false when the request does not fit until older regions are reclaimed.
+        bool       Allocate(size_t size, size_t alignment, Allocation& allocation);
+        // Tags every allocation made since the previous call with the timeline value that releases them.
+        void       Retire(uint64_t timelineValue);
+        void       Reclaim(uint64_t completedValue);
+
+        size_t     GetCapacity() const { return m_capacity; }
+        size_t     GetUsedSize() const { return m_usedSize; }
+
+        bool       HasRetiredRegions() const { return !m_retiredRegions.empty(); }
+        // Timeline value releasing the oldest retired region.
+        uint64_t   GetOldestRetiredValue() const { return m_retiredRegions.front().timelineValue; }
+
+    private:
+        struct Region
+        {
+            uint64_t timelineValue;
+            size_t   size;
+        };
+
+        IBuffer*           m_buffer      = nullptr;
+        uint8_t*           m_mappedPtr   = nullptr;
+        size_t             m_capacity    = 0;
+        size_t             m_head        = 0;
+        // Bytes in use, including padding lost when wrapping around.
+        size_t             m_usedSize    = 0;
+        // Bytes allocated since the last Retire call.
+        size_t             m_pendingSize = 0;
+        TL::Vector<Region> m_retiredRegions;
+    };
+
+    // Records uploads on the transfer queue and hands ownership over to the graphics queue.
+    class UploadEngine
+    {
+    public:
+        static constexpr size_t   StagingRingSize = 64 * 1024 * 1024;
+        static constexpr uint32_t BatchCount      = 4;
+
+        ResultCode Init(IDevice* device);
+        void       Shutdown(IDevice* device);
+
+        uint64_t   UploadBuffer(const BufferUploadInfo& uploadInfo);
+        uint64_t   UploadImage(const ImageUploadInfo& uploadInfo);
+
+        // Submits the open batch, must be called from the thread that submits to the graphics queue.
+        uint64_t   Flush();
+        // Reclaims staging memory and invokes the callbacks of completed uploads.
+        void       Poll();
+
+        IFence*    m_fence = nullptr;
+
+    private:
+        struct PendingCallback
+        {
+            UploadCallback callback;
+            void*          userData;
+        };
+
+        struct Batch
+        {
+            ICommandPool*                 transferPool          = nullptr;
+            ICommandPool*                 graphicsPool          = nullptr;
+            ICommandList*                 transferList          = nullptr;
+            uint64_t                      timelineValue         = 0;
+            // Graphics timeline value of the submission acquiring the batch's resources.
+            uint64_t                      graphicsTimelineValue = 0;
+            TL::Vector<ImageBarrierInfo>  imageAcquires;
+            TL::Vector<BufferBarrierInfo> bufferAcquires;
+            TL::Vector<PendingCallback>   callbacks;
+            // Staging buffers for uploads the ring could not hold, released once the batch is submitted.
+            TL::Vector<Buffer*>           dedicatedBuffers;
+        };
+
+        Batch&                  OpenBatch();
+        StagingRing::Allocation AllocateStaging(Batch& batch, size_t size, size_t alignment);
+        uint64_t                FlushLocked();
+        void                    ReclaimLocked();
+
+        std::mutex                  m_mutex;
+        IDevice*                    m_device = nullptr;
+        StagingRing                 m_stagingRing;
+        Batch                       m_batches[BatchCount];
+        uint32_t                    m_batchIndex     = 0;
+        bool                        m_batchOpen      = false;
+        uint64_t                    m_lastBatchValue = 0;
+        // Callbacks of completed batches, invoked by Poll outside of the lock.
+        TL::Vector<PendingCallback> m_readyCallbacks;
+    };
+} // namespace RHI::Vulkan
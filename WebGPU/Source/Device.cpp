@@ -81,7 +81,7 @@ namespace RHI::WebGPU
         (void)bgra;
     }
 
-    void IQueue::Submit(const QueueSubmitInfo& submitInfo)
+    uint64_t IQueue::Submit(const QueueSubmitInfo& submitInfo)
     {
         // Fences are no-ops for now; WebGPU's single queue orders submissions implicitly.
         TL::Vector<WGPUCommandBuffer> commandBuffers;
@@ -98,6 +98,27 @@ namespace RHI::WebGPU
 
         for (auto* swapchain : submitInfo.presentSwapchains)
             ((ISwapchain*)swapchain)->Present();
+
+        return 0;
+    }
+
+    uint64_t IQueue::SubmitBatch(TL::Span<const QueueSubmitInfo> submitInfos)
+    {
+        for (const auto& submitInfo : submitInfos)
+            Submit(submitInfo);
+        return 0;
+    }
+
+    void IQueue::Present(TL::Span<Swapchain* const> swapchains)
+    {
+        for (auto* swapchain : swapchains)
+            ((ISwapchain*)swapchain)->Present();
+    }
+
+    Fence* IQueue::GetTimelineFence()
+    {
+        // No-op: no host-side fence/timeline tracking yet.
+        return nullptr;
     }
 
     void IQueue::WaitIdle()
@@ -17,12 +17,15 @@ namespace RHI::WebGPU
         ResultCode Init(IDevice* device, QueueType queueType);
         void       Shutdown();
 
-        void BeginAnnotation(const char* name, uint32_t bgra) override;
-        void EndAnnotation() override;
-        void InsertAnnotation(const char* name, uint32_t bgra) override;
-        void Submit(const QueueSubmitInfo& submitInfo) override;
-        void WaitIdle() override;
-        void WaitFence(Fence* fence, uint64_t value) override;
+        void     BeginAnnotation(const char* name, uint32_t bgra) override;
+        void     EndAnnotation() override;
+        void     InsertAnnotation(const char* name, uint32_t bgra) override;
+        uint64_t Submit(const QueueSubmitInfo& submitInfo) override;
+        uint64_t SubmitBatch(TL::Span<const QueueSubmitInfo> submitInfos) override;
+        void     Present(TL::Span<Swapchain* const> swapchains) override;
+        Fence*   GetTimelineFence() override;
+        void     WaitIdle() override;
+        void     WaitFence(Fence* fence, uint64_t value) override;
 
         IDevice*  m_device    = nullptr;
         WGPUQueue m_queue     = nullptr;